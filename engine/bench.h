@@ -0,0 +1,26 @@
+﻿#pragma once
+#include <cstdint>
+
+constexpr int BENCH_DEPTH = 10;          // глубина по умолчанию для bench
+
+/* --------------------------------------------------------
+ *  bench: фиксированный набор позиций, каждая — search() на depth
+ *  с чистой TT. Сумма узлов при threads = 1 детерминирована
+ *  и служит подписью сборки: изменилась — изменился поиск.
+ *  Возвращает сумму узлов.
+ * --------------------------------------------------------*/
+uint64_t bench(int depth, int threads);
+
+constexpr int MOVEBENCH_DEPTH = 4;
+
+/* --------------------------------------------------------
+ *  movebench: полный обход дерева ходов (без хэша и bulk
+ *  counting) по позициям bench двумя способами — copy-make
+ *  (make_move в новую Position) и do_move/undo_move на месте.
+ *  Печатает время и Mnps обоих.
+ *  На голом обходе copy-make быстрее, поэтому perft остался на нём.
+ *  В поиске (bench nps) оба способа равны в пределах шума, а
+ *  инкрементальным NNUE-аккумулятору, pawnKey и psq стек StateInfo
+ *  нужен в любом случае, поэтому поиск ходит через do/undo.
+ * --------------------------------------------------------*/
+void movebench(int depth);
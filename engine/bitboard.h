@@ -2,19 +2,87 @@
 #include "types.h"
 #include <array>
 
-/*  / , !!!   !!!  */                           /*    avx -  */
+/* ——— Файловые/ранговые маски, !!!НЕ ТРОГАТЬ ПОКА РАБОТАЕТ!!! ——— */                           /*если будет ошибка в avx - смотреть сюда*/
 inline constexpr Bitboard FILE_A = 0x0101010101010101ULL;
 inline constexpr Bitboard FILE_H = 0x8080808080808080ULL;
 inline constexpr Bitboard RANK_1 = 0x00000000000000FFULL;
 inline constexpr Bitboard RANK_8 = 0xFF00000000000000ULL;
 
-/* ---    --- */
-extern std::array<Bitboard, 64> KnightAtt; // extern ,       
-extern std::array<Bitboard, 64> KingAtt;
-extern std::array<Bitboard, 64> PawnAttW;   //  : 
-extern std::array<Bitboard, 64> PawnAttB;   //  : 
+/* --- Предвычисленные битборды атак ---
+   считаются компилятором (constexpr) и лежат в .rodata: при старте
+   ничего не инициализируется */
+namespace AttackGen {
 
-void init_attack_tables();   //     
+    /* ---- Смещения фигур ---- */
+    constexpr int KNIGHT_D[8] = { 17,15,10,6,-17,-15,-10,-6 }; // +2 по вертикали, +1 по горизонтали и т.д.
+    constexpr int KING_D[8] = { 8,1,-8,-1,9,7,-9,-7 };
+
+    constexpr int file_dist(int a, int b) { int d = (a & 7) - (b & 7); return d < 0 ? -d : d; }
+
+    /* конь/король: смещение годится, если не ушли за доску и не перескочили край */
+    constexpr std::array<Bitboard, 64> leaper(const int (&d)[8], int maxFileDist) {
+        std::array<Bitboard, 64> t{};
+        for (int s = 0; s < 64; ++s)
+            for (int k = 0; k < 8; ++k) {
+                int to = s + d[k];
+                if (to >= 0 && to < 64 && file_dist(s, to) <= maxFileDist)
+                    t[s] |= one(Square(to));
+            }
+        return t;
+    }
+
+    constexpr std::array<Bitboard, 64> pawn(Side c) {
+        std::array<Bitboard, 64> t{};
+        for (int s = 0; s < 64; ++s) {
+            int r = s / 8, f = s % 8;
+            if (c == WHITE && r < 7) {
+                if (f > 0) t[s] |= one(Square(s + 7));
+                if (f < 7) t[s] |= one(Square(s + 9));
+            }
+            if (c == BLACK && r > 0) {
+                if (f > 0) t[s] |= one(Square(s - 9));
+                if (f < 7) t[s] |= one(Square(s - 7));
+            }
+        }
+        return t;
+    }
+
+    /* Лучи: идём из s по 8 направлениям, Between — поля строго между s и t,
+       Line — вся линия доски через s и t (для связанных фигур) */
+    using SquarePairs = std::array<std::array<Bitboard, 64>, 64>;
+
+    constexpr SquarePairs rays(bool wholeLine) {
+        constexpr int DF[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+        constexpr int DR[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+        SquarePairs t{};
+        for (int s = 0; s < 64; ++s)
+            for (int d = 0; d < 8; ++d) {
+                /* полная линия через s в этом направлении (в обе стороны) */
+                Bitboard line = one(Square(s));
+                for (int k = -1; k <= 1; k += 2)
+                    for (int f = s % 8 + k * DF[d], r = s / 8 + k * DR[d];
+                         f >= 0 && f < 8 && r >= 0 && r < 8; f += k * DF[d], r += k * DR[d])
+                        line |= one(Square(r * 8 + f));
+
+                Bitboard between = 0;
+                for (int f = s % 8 + DF[d], r = s / 8 + DR[d];
+                     f >= 0 && f < 8 && r >= 0 && r < 8; f += DF[d], r += DR[d]) {
+                    int t2 = r * 8 + f;
+                    t[s][t2] = wholeLine ? line : between;
+                    between |= one(Square(t2));
+                }
+            }
+        return t;
+    }
+
+} // namespace
+
+inline constexpr std::array<Bitboard, 64> KnightAtt = AttackGen::leaper(AttackGen::KNIGHT_D, 2);
+inline constexpr std::array<Bitboard, 64> KingAtt = AttackGen::leaper(AttackGen::KING_D, 1);
+inline constexpr std::array<Bitboard, 64> PawnAttW = AttackGen::pawn(WHITE);   // белая пешка: захваты
+inline constexpr std::array<Bitboard, 64> PawnAttB = AttackGen::pawn(BLACK);   // чёрная пешка: захваты
+inline constexpr AttackGen::SquarePairs BetweenBB = AttackGen::rays(false); // поля строго между s и t (0, если не на одной линии)
+inline constexpr AttackGen::SquarePairs LineBB = AttackGen::rays(true);     // вся линия через s и t (0, если не на одной линии)
 
 // ---------------------------------
 #ifdef _MSC_VER
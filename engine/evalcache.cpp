@@ -0,0 +1,51 @@
+﻿// engine/evalcache.cpp
+#include "evalcache.h"
+
+#include <atomic>
+#include <memory>
+
+namespace {
+
+    constexpr uint64_t KEY_MASK = ~0xFFFFULL;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> table;
+    size_t mask = 0;                             // размер - 1, размер — степень 2
+
+} // namespace
+
+void EvalCache::resize(size_t mb)
+{
+    table.reset();
+    mask = 0;
+    if (mb == 0) return;
+
+    /* наибольшая степень 2 записей, влезающая в mb */
+    size_t n = 1;
+    while (n * 2 * sizeof(uint64_t) <= mb * 1024 * 1024)
+        n *= 2;
+    table.reset(new std::atomic<uint64_t>[n]);
+    mask = n - 1;
+    clear();
+}
+
+void EvalCache::clear()
+{
+    for (size_t i = 0; table && i <= mask; ++i)
+        table[i].store(0, std::memory_order_relaxed);
+}
+
+bool EvalCache::probe(uint64_t key, int& eval)
+{
+    if (!table) return false;
+    uint64_t e = table[key & mask].load(std::memory_order_relaxed);
+    if (e == 0 || (e & KEY_MASK) != (key & KEY_MASK))
+        return false;
+    eval = int16_t(uint16_t(e));
+    return true;
+}
+
+void EvalCache::store(uint64_t key, int eval)
+{
+    if (!table) return;
+    table[key & mask].store((key & KEY_MASK) | uint16_t(int16_t(eval)), std::memory_order_relaxed);
+}
@@ -0,0 +1,22 @@
+﻿#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/* --------------------------------------------------------
+ *  Кэш статической оценки: Zobrist-ключ -> evaluate().
+ *  Общий для всех потоков и без блокировок: запись — одно
+ *  64-битное слово (старшие 48 бит ключа | 16 бит оценки),
+ *  поэтому разорванных записей не бывает, а чужая позиция
+ *  в том же слоте просто не пройдёт сверку ключа.
+ * --------------------------------------------------------*/
+namespace EvalCache {
+
+    constexpr size_t DEFAULT_MB = 8;
+
+    void resize(size_t mb);                      // setoption name EvalCache; 0 — выключен
+    void clear();                                // ucinewgame, новая сеть
+
+    bool probe(uint64_t key, int& eval);         // true — оценка найдена
+    void store(uint64_t key, int eval);
+
+} // namespace
@@ -1,14 +1,68 @@
 #pragma once
 
-#include "types.h"    //    Square, Side  
-#include "bitboard.h" //   typedef Bitboard = uint64_t
-
-// 
-void init_magic();
-Bitboard rook_attacks(Square sq, Bitboard occ);
-Bitboard bishop_attacks(Square sq, Bitboard occ);
-
-//   ( )
-extern Bitboard RookMask[64], BishopMask[64];
-extern Bitboard RookAttack[64][4096];
-extern Bitboard BishopAttack[64][512];
\ No newline at end of file
+#include "types.h"    //  там определены Square, Side и тд
+#include "bitboard.h" //  там typedef Bitboard = uint64_t
+
+/* --- способ индексации атак дальнобойных фигур ---
+   MAGIC — (occ & mask) * magic >> shift, работает везде;
+   PEXT  — _pext_u64(occ, mask), только в сборке WITH_PEXT (с -mbmi2
+           собирается один magic_pext.cpp) и только там, где CPU
+           умеет BMI2 и PEXT аппаратный (до Zen 3 у AMD он
+           микрокодный и медленнее магии) */
+enum class SliderBackend { MAGIC, PEXT };
+
+// апи
+void init_magic();                               // выбирает лучший способ для этого CPU (таблицы готовы заранее)
+void init_magic(SliderBackend b);                // принудительно (PEXT без WITH_PEXT или без BMI2 -> MAGIC)
+SliderBackend slider_backend();
+const char* slider_backend_name();
+// rook_attacks / bishop_attacks — inline в конце файла
+
+/* --- одна общая таблица атак (генерируется при сборке tools/slidergen.cpp),
+   у каждого поля свой кусок:
+   ладьи 102400 + слоны 5248 = 107648 записей (~840 КБ)
+   вместо 64*4096 + 64*512 (2.3 МБ, в основном пустых) --- */
+constexpr int SLIDER_TABLE_SIZE = 102400 + 5248;
+
+struct SliderInfo {
+    Bitboard  mask;      // релевантные поля луча (без краёв)
+    uint64_t  magic;
+    const Bitboard* attacks; // начало куска поля в общей таблице (.rodata)
+    unsigned  shift;
+};
+
+// внутренние таблицы (не трогаем)
+extern SliderInfo RookSlider[64], BishopSlider[64];
+
+/* --------------------------------------------------------
+ *  доступ к заранее сгенерированным атакам
+ * --------------------------------------------------------*/
+inline unsigned magic_index(const SliderInfo& s, Bitboard occ) {
+    return unsigned(((occ & s.mask) * s.magic) >> s.shift);
+}
+inline Bitboard rook_attacks_magic(Square sq, Bitboard occ) {
+    const SliderInfo& s = RookSlider[sq];
+    return s.attacks[magic_index(s, occ)];
+}
+inline Bitboard bishop_attacks_magic(Square sq, Bitboard occ) {
+    const SliderInfo& s = BishopSlider[sq];
+    return s.attacks[magic_index(s, occ)];
+}
+
+#if defined(USE_PEXT)
+// PEXT-варианты из magic_pext.cpp: вызывать только при BMI2 (slider_backend() == PEXT)
+Bitboard rook_attacks_pext(Square sq, Bitboard occ);
+Bitboard bishop_attacks_pext(Square sq, Bitboard occ);
+
+/* способ выбирает init_magic один раз: указатели на magic- или pext-вариант,
+   без проверки backend на каждом вызове */
+extern Bitboard (*RookAttacksFn)(Square, Bitboard);
+extern Bitboard (*BishopAttacksFn)(Square, Bitboard);
+
+inline Bitboard rook_attacks(Square sq, Bitboard occ)   { return RookAttacksFn(sq, occ); }
+inline Bitboard bishop_attacks(Square sq, Bitboard occ) { return BishopAttacksFn(sq, occ); }
+#else
+// без WITH_PEXT способ один — магия встраивается прямо в место вызова
+inline Bitboard rook_attacks(Square sq, Bitboard occ)   { return rook_attacks_magic(sq, occ); }
+inline Bitboard bishop_attacks(Square sq, Bitboard occ) { return bishop_attacks_magic(sq, occ); }
+#endif
\ No newline at end of file
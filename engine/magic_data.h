@@ -0,0 +1,158 @@
+﻿#pragma once
+// engine/magic_data.h — исходные данные для таблиц дальнобойных фигур:
+// маски, магические числа, сдвиги и медленный подсчёт атак.
+// Нужен только magic.cpp и генератору tools/slidergen.cpp,
+// в движке в горячем пути не используется.
+#include "types.h"     // Square, Side
+#include "bitboard.h"  // Bitboard, lsb_index
+#include <cstdint>
+
+namespace MagicData {
+
+    /* --------------------------------------------------------
+     *  Вспомогательные inline-утилиты
+     * --------------------------------------------------------*/
+    inline int popcount(uint64_t x) {
+        // SWAR-popcount, population_count читает, сколько битов установлено в 1 в 64-битном числе
+        x = x - ((x >> 1) & 0x5555555555555555ULL);
+        x = (x & 0x3333333333333333ULL) + ((x >> 2) & 0x3333333333333333ULL);
+        x = (x + (x >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+        return int((x * 0x0101010101010101ULL) >> 56);
+    }
+
+    inline int lsb(uint64_t b) { 
+        // Least Significant Bit - возвращает индекс младшего установленного бита (нужен для перебора маски)
+        return lsb_index(b);          // гарантируем b != 0
+    }
+
+    inline Bitboard one(int sq) { return 1ULL << sq; }
+
+
+    /* --------------------------------------------------------
+     *  Маски лучей
+     * --------------------------------------------------------*/
+    inline Bitboard mask_rook(Square sq) {
+        Bitboard m = 0;
+        int f = sq & 7, r = sq >> 3;
+        for (int ff = f + 1; ff <= 6; ++ff) m |= one(r * 8 + ff);
+        for (int ff = f - 1; ff >= 1; --ff) m |= one(r * 8 + ff);
+        for (int rr = r + 1; rr <= 6; ++rr) m |= one(rr * 8 + f);
+        for (int rr = r - 1; rr >= 1; --rr) m |= one(rr * 8 + f);
+        return m;
+    }
+    inline Bitboard mask_bishop(Square sq) {
+        Bitboard m = 0;
+        int f = sq & 7, r = sq >> 3;
+        for (int ff = f + 1, rr = r + 1; ff <= 6 && rr <= 6; ++ff, ++rr) m |= one(rr * 8 + ff);
+        for (int ff = f - 1, rr = r + 1; ff >= 1 && rr <= 6; --ff, ++rr) m |= one(rr * 8 + ff);
+        for (int ff = f + 1, rr = r - 1; ff <= 6 && rr >= 1; ++ff, --rr) m |= one(rr * 8 + ff);
+        for (int ff = f - 1, rr = r - 1; ff >= 1 && rr >= 1; --ff, --rr) m |= one(rr * 8 + ff);
+        return m;
+    }
+
+    /* --------------------------------------------------------
+     * атаки для генерации таблиц
+     * --------------------------------------------------------*/
+    inline Bitboard rook_attack_on_the_fly(Square sq, Bitboard occ) {
+        Bitboard a = 0;
+        int f = sq & 7, r = sq >> 3;
+        for (int ff = f + 1; ff <= 7; ++ff) { a |= one(r * 8 + ff); if (occ & one(r * 8 + ff)) break; }
+        for (int ff = f - 1; ff >= 0; --ff) { a |= one(r * 8 + ff); if (occ & one(r * 8 + ff)) break; }
+        for (int rr = r + 1; rr <= 7; ++rr) { a |= one(rr * 8 + f); if (occ & one(rr * 8 + f)) break; }
+        for (int rr = r - 1; rr >= 0; --rr) { a |= one(rr * 8 + f); if (occ & one(rr * 8 + f)) break; }
+        return a;
+    }
+    inline Bitboard bishop_attack_on_the_fly(Square sq, Bitboard occ) {
+        Bitboard a = 0;
+        int f = sq & 7, r = sq >> 3;
+        for (int ff = f + 1, rr = r + 1; ff <= 7 && rr <= 7; ++ff, ++rr) { a |= one(rr * 8 + ff); if (occ & one(rr * 8 + ff)) break; }
+        for (int ff = f - 1, rr = r + 1; ff >= 0 && rr <= 7; --ff, ++rr) { a |= one(rr * 8 + ff); if (occ & one(rr * 8 + ff)) break; }
+        for (int ff = f + 1, rr = r - 1; ff <= 7 && rr >= 0; ++ff, --rr) { a |= one(rr * 8 + ff); if (occ & one(rr * 8 + ff)) break; }
+        for (int ff = f - 1, rr = r - 1; ff >= 0 && rr >= 0; --ff, --rr) { a |= one(rr * 8 + ff); if (occ & one(rr * 8 + ff)) break; }
+        return a;
+    }
+
+    /* --------------------------------------------------------
+     *  Таблицы и «магия)))
+     * --------------------------------------------------------*/
+     /* Предрасчитанные магические числа и сдвиги для ладей и слонов
+      * Взяты из открытых источников (Pradyumna Kannan, используются в Crafty и др)
+      * Гарантируют уникальные индексы для occupancy без коллизий. Короче до этого я их считал в брутфорсом каждый запуск, ниже функция find_magic.
+      */
+    inline constexpr uint64_t RookMagic[64] = {
+        0x0080001020400080ULL, 0x0040001000200040ULL, 0x0080081000200080ULL, 0x0080040800100080ULL,
+        0x0080020400080080ULL, 0x0080010200040080ULL, 0x0080008001000200ULL, 0x0080002040800100ULL,
+        0x0000800020400080ULL, 0x0000400020005000ULL, 0x0000801000200080ULL, 0x0000800800100080ULL,
+        0x0000800400080080ULL, 0x0000800200040080ULL, 0x0000800100020080ULL, 0x0000800040800100ULL,
+        0x0000208000400080ULL, 0x0000404000201000ULL, 0x0000808010002000ULL, 0x0000808008001000ULL,
+        0x0000808004000800ULL, 0x0000808002000400ULL, 0x0000010100020004ULL, 0x0000020000408104ULL,
+        0x0000208080004000ULL, 0x0000200040005000ULL, 0x0000100080200080ULL, 0x0000080080100080ULL,
+        0x0000040080080080ULL, 0x0000020080040080ULL, 0x0000010080800200ULL, 0x0000800080004100ULL,
+        0x0000204000800080ULL, 0x0000200040401000ULL, 0x0000100080802000ULL, 0x0000080080801000ULL,
+        0x0000040080800800ULL, 0x0000020080800400ULL, 0x0000020001010004ULL, 0x0000800040800100ULL,
+        0x0000204000808000ULL, 0x0000200040008080ULL, 0x0000100020008080ULL, 0x0000080010008080ULL,
+        0x0000040008008080ULL, 0x0000020004008080ULL, 0x0000010002008080ULL, 0x0000004081020004ULL,
+        0x0000204000800080ULL, 0x0000200040008080ULL, 0x0000100020008080ULL, 0x0000080010008080ULL,
+        0x0000040008008080ULL, 0x0000020004008080ULL, 0x0000800100020080ULL, 0x0000800041000080ULL,
+        0x00FFFCDDFCED714AULL, 0x007FFCDDFCED714AULL, 0x003FFFCDFFD88096ULL, 0x0000040810002101ULL,
+        0x0001000204080011ULL, 0x0001000204000801ULL, 0x0001000082000401ULL, 0x0001FFFAABFAD1A2ULL
+    };
+    inline constexpr uint64_t BishopMagic[64] = {
+        0x0002020202020200ULL, 0x0002020202020000ULL, 0x0004010202000000ULL, 0x0004040080000000ULL,
+        0x0001104000000000ULL, 0x0000821040000000ULL, 0x0000410410400000ULL, 0x0000104104104000ULL,
+        0x0000040404040400ULL, 0x0000020202020200ULL, 0x0000040102020000ULL, 0x0000040400800000ULL,
+        0x0000011040000000ULL, 0x0000008210400000ULL, 0x0000004104104000ULL, 0x0000002082082000ULL,
+        0x0004000808080800ULL, 0x0002000404040400ULL, 0x0001000202020200ULL, 0x0000800802004000ULL,
+        0x0000800400A00000ULL, 0x0000200100884000ULL, 0x0000400082082000ULL, 0x0000200041041000ULL,
+        0x0002080010101000ULL, 0x0001040008080800ULL, 0x0000208004010400ULL, 0x0000404004010200ULL,
+        0x0000840000802000ULL, 0x0000404002011000ULL, 0x0000808001041000ULL, 0x0000404000820800ULL,
+        0x0001041000202000ULL, 0x0000820800101000ULL, 0x0000104400080800ULL, 0x0000020080080080ULL,
+        0x0000404040040100ULL, 0x0000808100020100ULL, 0x0001010100020800ULL, 0x0000808080010400ULL,
+        0x0000820820004000ULL, 0x0000410410002000ULL, 0x0000082088001000ULL, 0x0000002011000800ULL,
+        0x0000080100400400ULL, 0x0001010101000200ULL, 0x0002020202000400ULL, 0x0001010101000200ULL,
+        0x0000410410400000ULL, 0x0000208208200000ULL, 0x0000002084100000ULL, 0x0000000020880000ULL,
+        0x0000001002020000ULL, 0x0000040408020000ULL, 0x0004040404040000ULL, 0x0002020202020000ULL,
+        0x0000104104104000ULL, 0x0000002082082000ULL, 0x0000000020841000ULL, 0x0000000000208800ULL,
+        0x0000000010020200ULL, 0x0000000404080200ULL, 0x0000040404040400ULL, 0x0002020202020200ULL
+    };
+    inline constexpr uint8_t RookShift[64] = {
+        52, 53, 53, 53, 53, 53, 53, 52,
+        53, 54, 54, 54, 54, 54, 54, 53,
+        53, 54, 54, 54, 54, 54, 54, 53,
+        53, 54, 54, 54, 54, 54, 54, 53,
+        53, 54, 54, 54, 54, 54, 54, 53,
+        53, 54, 54, 54, 54, 54, 54, 53,
+        53, 54, 54, 54, 54, 54, 54, 53,
+        53, 54, 54, 53, 53, 53, 53, 53
+    };
+    inline constexpr uint8_t BishopShift[64] = {
+        58, 59, 59, 59, 59, 59, 59, 58,
+        59, 59, 59, 59, 59, 59, 59, 59,
+        59, 59, 57, 57, 57, 57, 59, 59,
+        59, 59, 57, 55, 55, 57, 59, 59,
+        59, 59, 57, 55, 55, 57, 59, 59,
+        59, 59, 57, 57, 57, 57, 59, 59,
+        59, 59, 59, 59, 59, 59, 59, 59,
+        58, 59, 59, 59, 59, 59, 59, 58
+    };
+
+
+    /* --------------------------------------------------------
+     *  вспомогательные функции
+     * --------------------------------------------------------*/
+    inline Bitboard index_to_occ(int index, Bitboard mask) {
+        Bitboard occ = 0;
+        while (mask) {
+            int sq = lsb(mask);
+            mask &= mask - 1;
+            if (index & 1) occ |= one(sq);
+            index >>= 1;
+        }
+        return occ;
+    }
+
+} // namespace
+/* -----------------------------------------------------------------
+ *  Попросил нейронку убрать нерабочие MSVC-intrinsics для popcount,
+ *  вместо них используется портируемый SWAR-алгоритм (не знаю что это пока что)
+ * -------------------------------------------------------------------*/
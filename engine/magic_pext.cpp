@@ -0,0 +1,16 @@
+﻿// engine/magic_pext.cpp — PEXT-индексация атак дальнобойных фигур.
+// Единственный файл, собираемый с -mbmi2 (см. CMakeLists.txt): остальной
+// движок остаётся на базовом x86-64, и без BMI2 сюда просто не заходим —
+// init_magic выбирает PEXT только по CPUID
+#include "magic.h"
+
+#include <immintrin.h> // _pext_u64
+
+Bitboard rook_attacks_pext(Square sq, Bitboard occ) {
+    const SliderInfo& s = RookSlider[sq];
+    return s.attacks[_pext_u64(occ, s.mask)];
+}
+Bitboard bishop_attacks_pext(Square sq, Bitboard occ) {
+    const SliderInfo& s = BishopSlider[sq];
+    return s.attacks[_pext_u64(occ, s.mask)];
+}
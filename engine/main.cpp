@@ -2,160 +2,310 @@
 #include <iostream>
 #include <sstream>
 #include <string>
-#include <vector>
-#include <cstring>      // memset
+#include "bench.h"
 #include "bitboard.h"
 #include "movegen.h"
+#include "perft.h"
 #include "position.h"
 #include "search.h"
 #include "zobrist.h"
 #include "tt.h"
+#include "evalcache.h"
 #include <chrono> 
+#include <algorithm>
+#include <cstdlib>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "magic.h"
+#ifdef USE_NNUE
+#include "nnue/simd.h"
+#endif
+
+/* UCI-поток и поток поиска пишут в stdout одновременно */
+static std::mutex g_outMutex;
 
 
 
 /* --------------------------------------------------------
  *  Преобразование строки «e2e4», «a7a8q» → Move
- *  (без проверки легальности: GUI гарантирует корректность)
+ *  Тип хода (рокировка, en-passant) в UCI-строке не виден —
+ *  ищем её среди легальных ходов позиции; 0 — такого хода нет
  * --------------------------------------------------------*/
-static Move uci_to_move(const std::string& s)
+static Move uci_to_move(const Position& pos, std::string s)
 {
-    if (s.length() < 4) return 0; // Проверка длинны строки минимум 4 символа
-    int fromFile = s[0] - 'a'; // Вычисляем file и rank из символов ASCII a..h → 0..7
-    int fromRank = s[1] - '1'; 
-    int toFile   = s[2] - 'a';
-    int toRank   = s[3] - '1';
-    Square from  = Square(fromFile + 8 * fromRank);
-    Square to    = Square(toFile   + 8 * toRank);
-
-    int promo = 0; 
-    if (s.length() == 5) { // Если есть пятый символ, разбираем символ продвижения пешки в promo (N, B, R, Q)
-        switch (std::tolower(s[4])) {
-        case 'n': promo = KNIGHT; break;
-        case 'b': promo = BISHOP; break;
-        case 'r': promo = ROOK;   break;
-        case 'q': promo = QUEEN;  break;
-        default:  promo = 0;
-        }
-    }
-    return make_move(from, to, promo);
-}
+    if (s.length() == 5)                        // промо GUI иногда шлёт заглавной
+        s[4] = char(std::tolower(s[4]));
 
-/* --------------------------------------------------------
- *  Вспомогательный perft (для отладки)
- * --------------------------------------------------------*/
-static uint64_t perft(Position& pos, int depth)
-{
-    if (depth == 0) return 1ULL;
-    std::vector<Move> list;
+    MoveList list;
     generate_moves(pos, list);
-
-    uint64_t nodes = 0;
-    Position nxt;
-    for (Move m : list) { // Для каждого хода
-        pos.make_move(m, nxt); // Строит новую позицию
-        nodes += perft(nxt, depth - 1); // Рекурсивно считает глубину
-    }
-    return nodes; // Возвращает общее число узлов
-} // Важно понимать, что здесь считаются вообще все узлы, без альфа-бета отсечения и тд.
-  // Тест нужен для проверки правильности играемых ходов, а не для их веса. 
-
+    for (Move m : list)
+        if (uci_move(m) == s)
+            return m;
+    return 0;
+}
 
 /* --------------------------------------------------------
  *  Применяем список ходов в UCI-формате к позиции
  *  (ходы легальны — GUI отвечает за это)
  * --------------------------------------------------------*/
-static void apply_move_list(Position& pos, std::istream& in)
+static void apply_move_list(Position& pos, std::vector<uint64_t>& keys, std::istream& in)
 {
     std::string mvStr;
     while (in >> mvStr) { // считаем по токену UCI ходы (e2e4 e7e5...) 
         if (mvStr == "go" || mvStr == "d" || mvStr == "perft" ||
             mvStr == "stop" || mvStr == "quit" || mvStr == "uci" ||
-            mvStr == "isready" || mvStr == "position")          // следующий токен
+            mvStr == "isready" || mvStr == "position" ||
+            mvStr == "setoption" || mvStr == "smpbench" ||
+            mvStr == "ponderhit" || mvStr == "bench" ||
+            mvStr == "perftsuite" || mvStr == "movebench")        // следующий токен
         {
             /* Вернули лишний токен обратно во входной поток */
             for (int i = int(mvStr.size()) - 1; i >= 0; --i)
                 in.putback(mvStr[i]);
             break;
         }
-        Move mv = uci_to_move(mvStr);
+        Move mv = uci_to_move(pos, mvStr);
         if (mv == 0) {
             std::cerr << "info string bad move " << mvStr << '\n';
             break;
         }
         Position nxt;
         pos.make_move(mv, nxt);
+        keys.push_back(pos.key);
+        if (nxt.rule50 == 0)                // до необратимого хода повторов не бывает
+            keys.clear();
         pos = nxt;
     }
 }
 
-void print_board(const Position& p) {
-    static const char sym[6] = { 'p','n','b','r','q','k' };
-    for (int r = 7; r >= 0; --r) {
-        for (int f = 0; f < 8; ++f) {
-            Square s = Square(f + 8 * r);
-            char c = '.';
-            for (int color = 0; color < 2; ++color) {
-                for (int pt = 0; pt < 6; ++pt) {
-                    if (p.bb[color][pt] & one(s)) {
-                        c = sym[pt];
-                        if (color == WHITE) c = char(::toupper(c));
-                    }
-                }
-            }
-            std::cout << c;
-        }
-        std::cout << '\n';
+/* --------------------------------------------------------
+ *  setoption name <имя> value <значение>
+ *  (имя может состоять из нескольких слов)
+ * --------------------------------------------------------*/
+static void parse_setoption(std::istream& in, std::string& name, std::string& value)
+{
+    std::string line, word;
+    std::getline(in, line);
+    std::istringstream ss(line);
+    ss >> word;                                   // "name"
+    while (ss >> word && word != "value")
+        name += (name.empty() ? "" : " ") + word;
+    while (ss >> word)
+        value += (value.empty() ? "" : " ") + word;
+}
+
+/* --------------------------------------------------------
+ *  smpbench [depth] [threads] — ускорение Lazy SMP:
+ *  одна и та же позиция сначала в 1 поток, потом в N,
+ *  с чистой TT перед каждым прогоном
+ * --------------------------------------------------------*/
+static void smp_bench(const Position& pos, int depth, int threads)
+{
+    double   sec[2]{};
+    uint64_t nodes[2]{};
+    const int runs[2] = { 1, threads };
+
+    for (int i = 0; i < 2; ++i) {
+        TT::clear(threads);
+        Position tmp = pos;
+        auto t0 = std::chrono::high_resolution_clock::now();
+        auto res = search(tmp, depth, runs[i]);
+        auto t1 = std::chrono::high_resolution_clock::now();
+        sec[i] = std::chrono::duration<double>(t1 - t0).count();
+        nodes[i] = res.nodes;
+
+        std::cout << "info string threads " << runs[i]
+            << " depth " << depth
+            << " time " << int(sec[i] * 1000) << " ms"
+            << " nodes " << nodes[i]
+            << " nps " << uint64_t(sec[i] > 0.0 ? nodes[i] / sec[i] : nodes[i])
+            << " bestmove " << uci_move(res.best) << '\n';
     }
-    std::cout << std::flush;
+
+    double nps1 = sec[0] > 0.0 ? nodes[0] / sec[0] : 0.0;
+    double npsN = sec[1] > 0.0 ? nodes[1] / sec[1] : 0.0;
+    std::cout << "info string speedup time-to-depth "
+        << (sec[1] > 0.0 ? sec[0] / sec[1] : 0.0)
+        << " nps " << (nps1 > 0.0 ? npsN / nps1 : 0.0) << std::endl;
+}
+
+/* --------------------------------------------------------
+ *  bench [depth] [threads] [hash] — и из UCI, и `engine bench`;
+ *  хэш на время прогона свой, потом возвращаем размер из опции Hash
+ * --------------------------------------------------------*/
+static void bench_cmd(std::istream& args, int hashMb)
+{
+    int depth = BENCH_DEPTH, n = 1, mb = int(TT::DEFAULT_MB);
+    args >> depth >> n >> mb;
+
+    TT::resize(size_t(std::max(1, std::min(65536, mb))));
+    bench(std::max(1, depth), std::max(1, std::min(256, n)));
+    TT::resize(size_t(hashMb));
+}
+
+/* --------------------------------------------------------
+ *  go depth / movetime / wtime / btime / winc / binc /
+ *  movestogo / infinite / ponder
+ * --------------------------------------------------------*/
+static SearchLimits parse_go(std::istream& in)
+{
+    std::string line;
+    std::getline(in, line);
+    std::istringstream ss(line);
+
+    SearchLimits lim;
+    std::string sub;
+    while (ss >> sub) {
+        if      (sub == "depth")     ss >> lim.depth;
+        else if (sub == "movetime")  ss >> lim.movetime;
+        else if (sub == "wtime")     ss >> lim.time[WHITE];
+        else if (sub == "btime")     ss >> lim.time[BLACK];
+        else if (sub == "winc")      ss >> lim.inc[WHITE];
+        else if (sub == "binc")      ss >> lim.inc[BLACK];
+        else if (sub == "movestogo") ss >> lim.movestogo;
+        else if (sub == "infinite")  lim.infinite = true;
+        else if (sub == "ponder")    lim.ponder = true;
+    }
+
+    /* голый go — как раньше, фиксированная глубина */
+    if (!lim.depth && !lim.movetime && !lim.time[WHITE] && !lim.time[BLACK] && !lim.infinite)
+        lim.depth = 4;
+    return lim;
 }
 
 /* --------------------------------------------------------
  *  Главный цикл UCI
  * --------------------------------------------------------*/
-int main()
+int main(int argc, char* argv[])
 {
     std::ios::sync_with_stdio(false);
     std::cin.tie(nullptr);
 
-    // 1) Сообщаем, что стартуем init_magic()
-    std::cerr << "init_magic() started...\n" << std::flush;
-
-    // 2) Замер времени
-    auto t0 = std::chrono::high_resolution_clock::now(); 
+    /* таблицы атак и Zobrist-ключи посчитаны при сборке (constexpr / slidergen),
+       здесь только выбор PEXT или магии под этот CPU */
     init_magic();
-    auto t1 = std::chrono::high_resolution_clock::now();
-
-    // 3) Выводим результат по завершении
-    double sec = std::chrono::duration<double>(t1 - t0).count();
-    std::cerr << "init_magic() done in " << sec << " sec" << std::endl;
-
-    init_attack_tables();
-    Zobrist::init();
+    std::cerr << "info string sliders " << slider_backend_name() << '\n';
+#ifdef USE_NNUE
+    NNUE::Simd::init();
+    std::cerr << "info string NNUE kernels " << NNUE::Simd::kernels().name << '\n';
+    if (NNUE::load(NNUE::DEFAULT_FILE))          // с диска, иначе встроенная
+        std::cerr << "info string NNUE " << NNUE::source() << " loaded\n";
+    else
+        std::cerr << "info string NNUE " << NNUE::DEFAULT_FILE << " not found, classical eval\n";
+#endif
 
     Position pos; // Заполняем таблицы атак (конь, король, пешки) и инициализируем Zobrist-ключи
+    std::vector<uint64_t> gameKeys; // ключи позиций партии до pos (с последнего необратимого хода)
     pos.set_startpos();          // текущая позиция
-    TT::table[0] = {};           //  она inline ??   *!!!19.05 ПОСМОТРЕТЬ ПРАВИЛЬНОСТЬ ТТ!!!*
+    int hashMb = int(TT::DEFAULT_MB);           // UCI-опция Hash
+    TT::resize(size_t(hashMb));
+    EvalCache::resize(EvalCache::DEFAULT_MB);   // UCI-опция EvalCache
+    int threads = 1;             // UCI-опция Threads
+    int overhead = TimeMan::DEFAULT_OVERHEAD;   // UCI-опция Move Overhead
+
+    /* прогоны без UCI-цикла:
+       engine bench [depth] [threads] [hash]
+       engine movebench [depth] — copy-make против do/undo
+       engine perftsuite <file.epd> [maxDepth] [threads] — код возврата 1 при несовпадениях */
+    if (argc > 1) {
+        std::string cmd = argv[1], args;
+        for (int i = 2; i < argc; ++i)
+            args += std::string(argv[i]) + ' ';
+        std::istringstream ss(args);
+        if (cmd == "bench") {
+            bench_cmd(ss, hashMb);
+            return 0;
+        }
+        if (cmd == "movebench") {
+            int d = MOVEBENCH_DEPTH;
+            ss >> d;
+            movebench(d);
+            return 0;
+        }
+        if (cmd == "perftsuite") {
+            std::string file;
+            int maxDepth = 0, n = 1;
+            ss >> file >> maxDepth >> n;
+            return perft_suite(file, maxDepth, std::max(1, n)) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+        }
+        std::cerr << "unknown command '" << cmd << "'\n";
+        return EXIT_FAILURE;
+    }
 
     std::string token;
     while (std::cin >> token)
     {
+        /* ---------- команды во время поиска ---------- */
+        if (token == "stop") {
+            stop_search();
+            continue;
+        }
+        if (token == "ponderhit") {
+            ponderhit();
+            continue;
+        }
+        if (token == "isready") {
+            std::lock_guard<std::mutex> lock(g_outMutex);
+            std::cout << "readyok" << std::endl;
+            continue;
+        }
+        if (token == "quit") break;
+
+        /* остальное меняет позицию/таблицы — ждём, пока поиск допечатает bestmove */
+        wait_search();
+
         /* ---------- базовые UCI-команды ---------- */
         if (token == "uci") {
             std::cout << "id name MyNNUEEngine 0.2.5\n"
                          "id author Danil Skvortsov 83151\n"
-                         "uciok\n";
+                         "option name Threads type spin default 1 min 1 max 256\n"
+                         "option name Hash type spin default 16 min 1 max 65536\n"
+                         "option name EvalCache type spin default 8 min 0 max 1024\n"
+                         "option name Move Overhead type spin default 30 min 0 max 5000\n"
+                         "option name Ponder type check default false\n"
+#ifdef USE_NNUE
+                      << "option name EvalFile type string default " << NNUE::DEFAULT_FILE << "\n"
+#endif
+                      << "uciok" << std::endl;
             continue;
         }
-        if (token == "isready") {
-            std::cout << "readyok\n";
+        if (token == "setoption") {
+            std::string name, value;
+            parse_setoption(std::cin, name, value);
+            if (name == "Threads")
+                threads = std::max(1, std::min(256, std::atoi(value.c_str())));
+            else if (name == "Hash") {
+                hashMb = std::max(1, std::min(65536, std::atoi(value.c_str())));
+                TT::resize(size_t(hashMb));
+            }
+            else if (name == "EvalCache")
+                EvalCache::resize(size_t(std::max(0, std::min(1024, std::atoi(value.c_str())))));
+            else if (name == "Move Overhead")
+                overhead = std::max(0, std::min(5000, std::atoi(value.c_str())));
+            else if (name == "Ponder") {
+                /* GUI сам решает, слать ли go ponder */
+            }
+#ifdef USE_NNUE
+            else if (name == "EvalFile") {
+                if (NNUE::load(value)) {
+                    EvalCache::clear();                  // оценки старой сети больше не годятся
+                    std::cout << "info string NNUE " << NNUE::source() << " loaded" << std::endl;
+                }
+                else
+                    std::cout << "info string NNUE cannot load '" << value << "', keeping "
+                        << (NNUE::loaded() ? NNUE::source() : "classical eval") << std::endl;
+            }
+#endif
+            else
+                std::cerr << "info string unknown option '" << name << "'\n";
             continue;
         }
-        if (token == "quit") break;
         if (token == "ucinewgame") {
             pos.set_startpos();
-            std::memset(TT::table, 0, sizeof(TT::table));
+            gameKeys.clear();
+            TT::clear(threads);
+            EvalCache::clear();
             continue;
         }
 
@@ -163,6 +313,7 @@ int main()
         if (token == "position")
         {
             Position tmp;
+            std::vector<uint64_t> keys;
             std::string sub;  std::cin >> sub;
 
             /* --- startpos или fen --- */
@@ -193,13 +344,14 @@ int main()
             std::string word;
             if (std::cin >> word) {
                 if (word == "moves")
-                    apply_move_list(tmp, std::cin);             // читаем все ходы
+                    apply_move_list(tmp, keys, std::cin);       // читаем все ходы
                 else                                            // это уже другой токен
                     for (int i = int(word.size()) - 1; i >= 0; --i)
                         std::cin.putback(word[i]);
             }
 
             pos = tmp;                                          // делаем новую позицию
+            gameKeys = keys;
             continue;
         }
 
@@ -211,51 +363,99 @@ int main()
         /* ---------- поиск ---------- */
         if (token == "go")
         {
-            // 1) Считываем остаток строки командой getline
+            // 1) Разбираем лимиты: глубина, часы, infinite/ponder
+            SearchLimits lim = parse_go(std::cin);
+
+            // 2) Поиск уходит в свой поток; bestmove печатает он же по окончании
+            auto t0 = std::chrono::high_resolution_clock::now();
+            start_search(pos, gameKeys, lim, threads, overhead, [t0](const SearchResult& res) {
+                auto t1 = std::chrono::high_resolution_clock::now();
+                double sec = std::chrono::duration<double>(t1 - t0).count();
+                uint64_t nps = sec > 0.0
+                    ? static_cast<uint64_t>(res.nodes / sec)
+                    : res.nodes;
+
+                // 3) Выводим info о глубине, узлах и nps, и затем bestmove
+                std::lock_guard<std::mutex> lock(g_outMutex);
+                std::cout << "info depth " << res.depth
+                    << " nodes " << res.nodes
+                    << " nps " << nps
+                    << " time " << int64_t(sec * 1000)
+                    << " score cp " << res.score
+                    << " hashfull " << TT::hashfull()
+                    << '\n';
+                std::cout << "info string qsearch nodes " << res.qnodes << " ("
+                    << (res.nodes ? 100 * res.qnodes / res.nodes : 0) << "%)\n";
+                uint64_t probes = res.evalHits + res.evalMisses;
+                std::cout << "info string evalcache hits " << res.evalHits
+                    << " misses " << res.evalMisses << " ("
+                    << (probes ? 100 * res.evalHits / probes : 0) << "%)\n";
+                std::cout << "bestmove " << uci_move(res.best) << std::endl;
+            });
+            continue;
+        }
+
+        /* ---------- perft [divide] N ---------- (для тестов) */
+        if (token == "perft") {
             std::string line;
             std::getline(std::cin, line);
             std::istringstream ss(line);
+            std::string arg;
+            ss >> arg;
+            bool divide = arg == "divide";               // perft divide N
+            if (divide) ss >> arg;
+            int d = std::atoi(arg.c_str());
 
-            // 2) Парсим depth / movetime / wtime / btime (пока без movetime/wtime/btime)                                       #TODO
-            int depth = 4;           // значение по умолчанию
-            std::string sub;
-            while (ss >> sub) {
-                if (sub == "depth") {
-                    ss >> depth;
-                }
-                else if (sub == "movetime" || sub == "wtime" || sub == "btime") {
-                    int skip; ss >> skip;
-                    // todo здесь можно запомнить time-control                                                                  #TODO
-                }
-                // todo когда нить добавить обработку "infinite" и др                                                           #TODO
-            }
-
-            // 3) Запускаем поиск ровно один раз под таймером
             auto t0 = std::chrono::high_resolution_clock::now();
-            auto res = search(pos, depth);
+            uint64_t n = perft(pos, d, threads, divide);
             auto t1 = std::chrono::high_resolution_clock::now();
-
             double sec = std::chrono::duration<double>(t1 - t0).count();
-            uint64_t nps = sec > 0.0
-                ? static_cast<uint64_t>(res.nodes / sec)
-                : res.nodes;
-
-            // 4) Выводим info о глубине, узлах и nps, и затем bestmove
-            std::cout << "info depth " << depth
-                << " nodes " << res.nodes
-                << " nps " << nps
-                << " score cp " << res.score
-                << '\n';
-            std::cout << "bestmove " << uci_move(res.best) << '\n';
+            std::cout << "info nodes " << n
+                << " time " << int64_t(sec * 1000)
+                << " nps " << uint64_t(sec > 0.0 ? n / sec : n) << std::endl;
             continue;
         }
 
-        /* ---------- perft N ---------- (для тестов) */
-        if (token == "perft") {
-            int d; std::cin >> d;
-            Position tmp = pos;
-            uint64_t n = perft(tmp, d);
-            std::cout << "info nodes " << n << std::endl;
+        /* ---------- smpbench [depth] [threads] ---------- */
+        if (token == "smpbench") {
+            std::string line;
+            std::getline(std::cin, line);
+            std::istringstream ss(line);
+            int depth = 8, n = int(std::thread::hardware_concurrency());
+            ss >> depth >> n;
+            smp_bench(pos, depth, std::max(1, n));
+            continue;
+        }
+
+        /* ---------- perftsuite <file.epd> [maxDepth] ---------- */
+        if (token == "perftsuite") {
+            std::string line;
+            std::getline(std::cin, line);
+            std::istringstream ss(line);
+            std::string file;
+            int maxDepth = 0;
+            ss >> file >> maxDepth;
+            perft_suite(file, maxDepth, threads);
+            continue;
+        }
+
+        /* ---------- bench [depth] [threads] [hash] ---------- */
+        if (token == "bench") {
+            std::string line;
+            std::getline(std::cin, line);
+            std::istringstream ss(line);
+            bench_cmd(ss, hashMb);
+            continue;
+        }
+
+        /* ---------- movebench [depth] ---------- */
+        if (token == "movebench") {
+            std::string line;
+            std::getline(std::cin, line);
+            std::istringstream ss(line);
+            int d = MOVEBENCH_DEPTH;
+            ss >> d;
+            movebench(d);
             continue;
         }
 
@@ -263,5 +463,7 @@ int main()
         std::cerr << "info string unknown token '" << token << "'\n";
     }
 
+    stop_search();
+    wait_search();
     return 0;
 }
@@ -1,19 +1,26 @@
 ﻿#pragma once
 #include "types.h"
+#include <cstddef>
 #include <cstdint>
 #include <string>
 
-using Move = uint32_t;          // 0-15: from, 6-11: to, 12-14: промо-фигура (0 = нет)
+/* ход — 16 бит: 0-5 from, 6-11 to, 12-13 промо-фигура (KNIGHT..QUEEN минус KNIGHT),
+   14-15 тип хода. Рокировка — ход короля (e1g1), как в UCI.
+   0 (a1a1) — "нет хода", легальным он не бывает */
+using Move = uint16_t;
+
+enum MoveType : uint16_t { NORMAL = 0, PROMOTION = 1 << 14, EN_PASSANT = 2 << 14, CASTLING = 3 << 14 };
 
 enum Promo : int { NO_PR = 0, PRN = KNIGHT, PRB = BISHOP, PRR = ROOK, PRQ = QUEEN }; // определение превращения пешки
 
-constexpr Move make_move(Square from, Square to, int promo = 0) // собираем move из трех полей from to promo
+constexpr Move make_move(Square from, Square to, MoveType type = NORMAL, int promo = KNIGHT) // собираем move: from to тип промо
 {
-    return (from) | (to << 6) | (promo << 12);
+    return Move(from | (to << 6) | ((promo - KNIGHT) << 12) | type);
 }
 inline constexpr Square from_sq(Move m) { return Square(m & 0x3F); } // исходный квадрта
 inline constexpr Square to_sq(Move m) { return Square((m >> 6) & 0x3F); } // цвелевой квадрат 
-inline constexpr int promo_of(Move m) { return  (m >> 12) & 7; } // превращение или нет 
+inline constexpr MoveType type_of(Move m) { return MoveType(m & (3 << 14)); } // тип хода
+inline constexpr int promo_of(Move m) { return type_of(m) == PROMOTION ? ((m >> 12) & 3) + KNIGHT : 0; } // фигура превращения или 0
 
 // -------------- popcount (64-бит) --------------
 #ifdef _MSC_VER          // MSVC
@@ -51,3 +58,36 @@ inline int mvv_lva_score(PieceType victim, PieceType attacker)
     static constexpr int V[6] = { 100, 320, 330, 500, 900, 20000 }; // K=бесконечность
     return V[victim] - attacker;   // чем больше тем лучше захват
 }
+
+/*-------------------------------------------------------------
+   MoveList — список ходов фиксированной ёмкости на стеке
+   (по образцу ValueList из misc.h), ни одной аллокации в узле.
+   У каждого хода своя оценка для сортировки.
+ *------------------------------------------------------------*/
+constexpr int MAX_MOVES = 256;          // в легальной позиции ходов не больше 218
+
+struct ExtMove {
+    Move move;
+    int  score;
+
+    operator Move() const { return move; }
+};
+
+class MoveList {
+
+   public:
+    std::size_t    size() const { return size_; }
+    bool           empty() const { return size_ == 0; }
+    void           clear() { size_ = 0; }
+    void           push_back(Move m) { moves_[size_++] = { m, 0 }; }
+    ExtMove*       begin() { return moves_; }
+    ExtMove*       end() { return moves_ + size_; }
+    const ExtMove* begin() const { return moves_; }
+    const ExtMove* end() const { return moves_ + size_; }
+    ExtMove&       operator[](int index) { return moves_[index]; }
+    const ExtMove& operator[](int index) const { return moves_[index]; }
+
+   private:
+    ExtMove     moves_[MAX_MOVES];
+    std::size_t size_ = 0;
+};
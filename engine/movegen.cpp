@@ -6,7 +6,6 @@
 #include "bitboard.h"
 #include <cstdlib>   // abs
 #include <array>
-#include <vector>
 #include "magic.h"
 
 /* --------------------------------------------------------
@@ -27,7 +26,7 @@ static const int DIR_DIAG[4] = { 9, 7, -9, -7 }; // диагонали
  *  Вспомогательная функция «толкнуть» слайдер (слон/ладья/ферзь)
  * --------------------------------------------------------*/
 static void push_slider(const Position& pos /*текущая позиция*/, Side us /*чей ход*/, Square from /*откула начинается луч*/,
-    const int* dirs /*указатель на массив направлений*/, std::vector<Move>& list /*куда добавлять ходы*/)
+    const int* dirs /*указатель на массив направлений*/, MoveList& list /*куда добавлять ходы*/)
 {
     Bitboard own = pos.occ[us]; // битборд фигур us
 
@@ -65,7 +64,7 @@ static void push_slider(const Position& pos /*текущая позиция*/, S
 /* --------------------------------------------------------
  *  Хелпер: добавляет либо один обычный ход, либо 4 хода‑промоции
  * --------------------------------------------------------*/
-static inline void push_pawn_move(std::vector<Move>& list,
+static inline void push_pawn_move(MoveList& list,
     Square from, Square to, bool is_promotion)
 {
     if (!is_promotion)
@@ -75,236 +74,316 @@ static inline void push_pawn_move(std::vector<Move>& list,
     }
 
     // 4 стандартные фигуры‑промоции
-    list.push_back(make_move(from, to, QUEEN));
-    list.push_back(make_move(from, to, ROOK));
-    list.push_back(make_move(from, to, BISHOP));
-    list.push_back(make_move(from, to, KNIGHT));
+    list.push_back(make_move(from, to, PROMOTION, QUEEN));
+    list.push_back(make_move(from, to, PROMOTION, ROOK));
+    list.push_back(make_move(from, to, PROMOTION, BISHOP));
+    list.push_back(make_move(from, to, PROMOTION, KNIGHT));
 }
 
 /* --------------------------------------------------------
- *  Генерация ПСЕВДОЛЕГАЛЬНЫХ ходов (по правилам ходов, без учёта шаха)
+ *  Генерация ЛЕГАЛЬНЫХ ходов сразу, без make_move на каждый ход:
+ *  заранее считаем шахующие фигуры, связанные фигуры и маску
+ *  «закрыться/побить» при шахе. Дополнительная проверка атак
+ *  нужна только для ходов короля и взятия en-passant.
+ *
+ *  Type делит ходы на две непересекающиеся части для MovePicker:
+ *  CAPTURES — взятия (с en-passant) и все превращения,
+ *  QUIETS   — всё остальное, включая рокировку.
  * --------------------------------------------------------*/
-static void generate_pseudo(const Position& pos, std::vector<Move>& list)
+enum GenType { CAPTURES, QUIETS, LEGAL };
+
+/* наши фигуры, связанные с королём на ksq: ровно одна фигура
+   между королём и вражеской дальнобойной на общей линии */
+static Bitboard pinned_pieces(const Position& pos, Square ksq)
+{
+    const Side us = pos.stm, them = Side(us ^ 1);
+    Bitboard pinned = 0;
+    Bitboard snipers =
+        (rook_attacks(ksq, 0) & (pos.bb[them][ROOK] | pos.bb[them][QUEEN])) |
+        (bishop_attacks(ksq, 0) & (pos.bb[them][BISHOP] | pos.bb[them][QUEEN]));
+    while (snipers)
+    {
+        Square s = pop_lsb(snipers);
+        Bitboard b = BetweenBB[ksq][s] & pos.occ_all;
+        if (b && !(b & (b - 1)) && (b & pos.occ[us])) // ровно одна фигура, и она наша
+            pinned |= b;
+    }
+    return pinned;
+}
+
+/* en-passant пешкой с from: с доски уходят две пешки (связки по горизонтали
+   не ловятся) — смотрим, бьёт ли кто короля при занятости после хода;
+   взятая пешка уже не шахует */
+static bool ep_legal(const Position& pos, Square from, Square ksq)
+{
+    const Side us = pos.stm, them = Side(us ^ 1);
+    const Square to = pos.ep;
+    const Bitboard cap = one((us == WHITE) ? Square(to - 8) : Square(to + 8));
+    const Bitboard after = (pos.occ_all ^ one(from) ^ cap) | one(to);
+    return !(pos.attackers_to(ksq, after) & pos.occ[them] & ~cap);
+}
+
+template<GenType Type>
+static void generate(const Position& pos, MoveList& list)
 {
-    list.clear(); // очищаем входной вектор 
+    list.clear(); // очищаем входной список
     const Side us = pos.stm; // текущий игрок black/white
     const Side them = Side(us ^ 1); // противник
+    const Bitboard occ = pos.occ_all;
+    const Bitboard empty = ~occ; // пустые клетки
+    const Square ksq = Square(lsb_index(pos.bb[us][KING]));
 
-    /* ---------------- Пешки ---------------- */
-    Bitboard pawns = pos.bb[us][PAWN]; // все пешки нашего цвета
-    const Bitboard empty = ~pos.occ_all; // пустые клетки
+    /* куда вообще разрешено ходить фигурам в этой части генерации */
+    const Bitboard typeMask = Type == CAPTURES ? pos.occ[them]
+                            : Type == QUIETS   ? empty
+                            : ~pos.occ[us];
 
-    if (us == WHITE)
+    /* ---------------- Шахи и связки ---------------- */
+    const Bitboard checkers = pos.attackers_to(ksq, occ) & pos.occ[them];
+    const Bitboard pinned = pinned_pieces(pos, ksq);
+
+    /* ---------------- Король ---------------- */
+    /* короля убираем из занятости, чтобы он не «прятался» от луча сам за собой */
+    Bitboard kTargets = KingAtt[ksq] & typeMask;
+    while (kTargets)
     {
-        /* ---- простой шаг вперёд ---- */
-        Bitboard oneStep = north(pawns) & empty; // переместить все пешки вперед но только если пустые клетки
-        Bitboard bb = oneStep; // 
-        while (bb)
-        {
-            Square to = pop_lsb(bb); // извлечь целевой квадрат и удалить бит lsb
-            Square from = Square(to - 8); // исходный квадрат на 8 ниже
-            bool promo = (to >> 3) == 7;        // достигли 8‑й горизонтали
-            push_pawn_move(list, from, to, promo); // добавляем ход или промоцию (превращшение) 
-        }
+        Square to = pop_lsb(kTargets);
+        if (!(pos.attackers_to(to, occ ^ one(ksq)) & pos.occ[them]))
+            list.push_back(make_move(ksq, to));
+    }
 
-        /* ---- двойной шаг с 2‑й линии ---- */
-        Bitboard single = oneStep;               // уже вычислено
-        Bitboard rank4 = 0x00000000FF000000ULL; // 4‑я горизонталь (a4‑h4)
-        Bitboard doubleStep = north(single) & empty & rank4; // в случае даблстепа 
+    if (checkers & (checkers - 1)) // двойной шах — ходит только король
+        return;
 
-        bb = doubleStep;
-        while (bb)
-        {
-            Square to = pop_lsb(bb);
-            Square from = Square(to - 16); // из двух рядов ниже
-            list.push_back(make_move(from, to)); // двойной ход никогда не промоция
-        }
+    /* при шахе — побить шахующую или встать между ней и королём */
+    Bitboard evasion = ~0ULL;
+    if (checkers)
+        evasion = checkers | BetweenBB[ksq][lsb_index(checkers)];
 
-        /* ---- захваты ---- */
-        Bitboard capL = (pawns << 7) & pos.occ[them] & ~FILE_H; // взятие влево
-        Bitboard capR = (pawns << 9) & pos.occ[them] & ~FILE_A; // взятие вправо
+    /* связанная фигура ходит только вдоль линии связки */
+    auto legal_pin = [&](Square from, Square to) {
+        return !(pinned & one(from)) || (LineBB[ksq][from] & one(to));
+    };
 
-        bb = capL; 
-        while (bb)
-        {
-            Square to = pop_lsb(bb);
-            Square from = Square(to - 7);
-            bool promo = (to >> 3) == 7;
-            push_pawn_move(list, from, to, promo);
-        }
-        bb = capR;
-        while (bb)
-        {
-            Square to = pop_lsb(bb);
-            Square from = Square(to - 9);
-            bool promo = (to >> 3) == 7;
-            push_pawn_move(list, from, to, promo);
-        }
-    }
-    else /* ---------------- ЧЕРНЫЕ Пешки ---------------- */
+    /* ---------------- Пешки ---------------- */
+    const Bitboard pawns = pos.bb[us][PAWN]; // все пешки нашего цвета
+    const int  up = (us == WHITE) ? 8 : -8;
+    const Bitboard promoRank = (us == WHITE) ? RANK_8 : RANK_1;
+    const Bitboard rank3 = (us == WHITE) ? 0x0000000000FF0000ULL : 0x0000FF0000000000ULL;
+
+    Bitboard oneStep = ((us == WHITE) ? north(pawns) : south(pawns)) & empty;
+    Bitboard twoStep = ((us == WHITE) ? north(oneStep & rank3) : south(oneStep & rank3)) & empty;
+
+    /* тихие шаги и двойной шаг; шаг‑превращение считается «взятием» */
+    Bitboard pushes = oneStep & evasion;
+    if (Type == QUIETS)   pushes &= ~promoRank;
+    if (Type == CAPTURES) pushes &= promoRank;
+    twoStep &= evasion;
+
+    while (pushes)
     {
-        Bitboard oneStep = south(pawns) & empty;
-        Bitboard bb = oneStep;
-        while (bb)
+        Square to = pop_lsb(pushes);
+        Square from = Square(to - up);
+        if (legal_pin(from, to))
+            push_pawn_move(list, from, to, (one(to) & promoRank) != 0);
+    }
+    if (Type != CAPTURES)
+        while (twoStep)
         {
-            Square to = pop_lsb(bb);
-            Square from = Square(to + 8);
-            bool promo = (to >> 3) == 0;        // достигли 1‑й горизонтали
-            push_pawn_move(list, from, to, promo);
+            Square to = pop_lsb(twoStep);
+            Square from = Square(to - 2 * up); // двойной ход никогда не промоция
+            if (legal_pin(from, to))
+                list.push_back(make_move(from, to));
         }
 
-        /* ---- двойной шаг с 7-й линии ---- */
-        Bitboard singleB = oneStep;
-        Bitboard rank5 = 0x000000FF00000000ULL; // 5‑я горизонталь (a5‑h5)
-        Bitboard doubleStepB = south(singleB) & empty & rank5;
-
-        bb = doubleStepB;
-        while (bb)
+    if (Type != QUIETS)
+    {
+        Bitboard capL = ((us == WHITE) ? (pawns << 7) : (pawns >> 9)) & ~FILE_H & pos.occ[them] & evasion;
+        Bitboard capR = ((us == WHITE) ? (pawns << 9) : (pawns >> 7)) & ~FILE_A & pos.occ[them] & evasion;
+        while (capL)
         {
-            Square to = pop_lsb(bb);
-            Square from = Square(to + 16);
-            list.push_back(make_move(from, to));
+            Square to = pop_lsb(capL);
+            Square from = Square(to - up + 1);
+            if (legal_pin(from, to))
+                push_pawn_move(list, from, to, (one(to) & promoRank) != 0);
         }
-
-        /* ---- захваты ---- */
-        Bitboard capL = (pawns >> 9) & pos.occ[them] & ~FILE_H;
-        Bitboard capR = (pawns >> 7) & pos.occ[them] & ~FILE_A;
-
-        bb = capL;
-        while (bb)
+        while (capR)
         {
-            Square to = pop_lsb(bb);
-            Square from = Square(to + 9);
-            bool promo = (to >> 3) == 0;
-            push_pawn_move(list, from, to, promo);
+            Square to = pop_lsb(capR);
+            Square from = Square(to - up - 1);
+            if (legal_pin(from, to))
+                push_pawn_move(list, from, to, (one(to) & promoRank) != 0);
         }
-        bb = capR;
-        while (bb)
+
+        /* --------- En‑passant: редкий ход, проверяем отдельно (ep_legal) --------- */
+        if (pos.ep != SQ_NONE)
         {
-            Square to = pop_lsb(bb);
-            Square from = Square(to + 7);
-            bool promo = (to >> 3) == 0;
-            push_pawn_move(list, from, to, promo);
+            Bitboard epAttackers = (us == WHITE) ? PawnAttB[pos.ep] : PawnAttW[pos.ep];
+            Bitboard pawnsCan = epAttackers & pawns;
+            while (pawnsCan)
+            {
+                Square from = pop_lsb(pawnsCan);
+                if (ep_legal(pos, from, ksq))
+                    list.push_back(make_move(from, pos.ep, EN_PASSANT));
+            }
         }
     }
 
-    /* ---------------- Кони ---------------- */
-    Bitboard knights = pos.bb[us][KNIGHT];
+    /* ---------------- Кони / слоны / ладьи / ферзи ---------------- */
+    const Bitboard target = typeMask & evasion;
+
+    Bitboard knights = pos.bb[us][KNIGHT] & ~pinned; // связанный конь не ходит вообще
     while (knights)
     {
         Square from = pop_lsb(knights);
-        Bitboard targets = KnightAtt[from] & ~pos.occ[us];
-        Bitboard bbK = targets;
-        while (bbK)
-        {
-            Square to = pop_lsb(bbK);
-            list.push_back(make_move(from, to));
-        }
-    }
-
-    /* ---------------- Слоны ---------------- */
-    Bitboard bishops = pos.bb[us][BISHOP];
-    while (bishops) {
-        Square from = pop_lsb(bishops);
-        Bitboard attacks = bishop_attacks(from, pos.occ_all) & ~pos.occ[us];
-        while (attacks) {
-            Square to = pop_lsb(attacks);
-            list.push_back(make_move(from, to));
-        }
+        Bitboard targets = KnightAtt[from] & target;
+        while (targets)
+            list.push_back(make_move(from, pop_lsb(targets)));
     }
 
-    /* ---------------- Ладьи ---------------- */
-    Bitboard rooks = pos.bb[us][ROOK];
-    while (rooks) {
-        Square from = pop_lsb(rooks);
-        Bitboard attacks = rook_attacks(from, pos.occ_all) & ~pos.occ[us];
-        while (attacks) {
-            Square to = pop_lsb(attacks);
-            list.push_back(make_move(from, to));
-        }
+    Bitboard diag = pos.bb[us][BISHOP] | pos.bb[us][QUEEN];
+    while (diag) {
+        Square from = pop_lsb(diag);
+        Bitboard attacks = bishop_attacks(from, occ) & target;
+        if (pinned & one(from)) attacks &= LineBB[ksq][from];
+        while (attacks)
+            list.push_back(make_move(from, pop_lsb(attacks)));
     }
 
-    /* ---------------- Ферзи ---------------- */
-    Bitboard queens = pos.bb[us][QUEEN];
-    while (queens) {
-        Square from = pop_lsb(queens);
-        Bitboard attacks =
-            (bishop_attacks(from, pos.occ_all) |
-                rook_attacks(from, pos.occ_all))
-            & ~pos.occ[us];
-        while (attacks) {
-            Square to = pop_lsb(attacks);
-            list.push_back(make_move(from, to));
-        }
+    Bitboard orth = pos.bb[us][ROOK] | pos.bb[us][QUEEN];
+    while (orth) {
+        Square from = pop_lsb(orth);
+        Bitboard attacks = rook_attacks(from, occ) & target;
+        if (pinned & one(from)) attacks &= LineBB[ksq][from];
+        while (attacks)
+            list.push_back(make_move(from, pop_lsb(attacks)));
     }
 
-    /* ---------------- Король ---------------- */
-    Square ksq = Square(lsb_index(pos.bb[us][KING]));
-    Bitboard kTargets = KingAtt[ksq] & ~pos.occ[us];
-    Bitboard bbK = kTargets;
-    while (bbK)
-    {
-        Square to = pop_lsb(bbK);
-        list.push_back(make_move(ksq, to));
-    }
+    /* --------- Рокировка (только не под шахом) --------- */
+    if (Type == CAPTURES || checkers)
+        return;
 
-    /* --------- Рокировка --------- */
     if (us == WHITE)
     {
         if ((pos.cr & WOO) &&
-            !(pos.occ_all & (one(F1) | one(G1))) &&
-            !pos.attacked(E1, them) && !pos.attacked(F1, them) && !pos.attacked(G1, them))
-            list.push_back(make_move(E1, G1));
+            !(occ & (one(F1) | one(G1))) &&
+            !pos.attacked(F1, them) && !pos.attacked(G1, them))
+            list.push_back(make_move(E1, G1, CASTLING));
 
         if ((pos.cr & WOOO) &&
-            !(pos.occ_all & (one(B1) | one(C1) | one(D1))) &&
-            !pos.attacked(E1, them) && !pos.attacked(D1, them) && !pos.attacked(C1, them))
-            list.push_back(make_move(E1, C1));
+            !(occ & (one(B1) | one(C1) | one(D1))) &&
+            !pos.attacked(D1, them) && !pos.attacked(C1, them))
+            list.push_back(make_move(E1, C1, CASTLING));
     }
     else
     {
         if ((pos.cr & BOO) &&
-            !(pos.occ_all & (one(F8) | one(G8))) &&
-            !pos.attacked(E8, them) && !pos.attacked(F8, them) && !pos.attacked(G8, them))
-            list.push_back(make_move(E8, G8));
+            !(occ & (one(F8) | one(G8))) &&
+            !pos.attacked(F8, them) && !pos.attacked(G8, them))
+            list.push_back(make_move(E8, G8, CASTLING));
 
         if ((pos.cr & BOOO) &&
-            !(pos.occ_all & (one(B8) | one(C8) | one(D8))) &&
-            !pos.attacked(E8, them) && !pos.attacked(D8, them) && !pos.attacked(C8, them))
-            list.push_back(make_move(E8, C8));
-    }
-
-    /* --------- En‑passant --------- */
-    if (pos.ep != SQ_NONE)
-    {
-        Bitboard epAttackers = (us == WHITE) ? PawnAttB[pos.ep] : PawnAttW[pos.ep];
-        Bitboard pawnsCan = epAttackers & pos.bb[us][PAWN];
-        while (pawnsCan)
-        {
-            Square from = pop_lsb(pawnsCan);
-            list.push_back(make_move(from, pos.ep));
-        }
+            !(occ & (one(B8) | one(C8) | one(D8))) &&
+            !pos.attacked(D8, them) && !pos.attacked(C8, them))
+            list.push_back(make_move(E8, C8, CASTLING));
     }
 }
 
+void generate_moves(const Position& pos, MoveList& list)    { generate<LEGAL>(pos, list); }
+void generate_captures(const Position& pos, MoveList& list) { generate<CAPTURES>(pos, list); }
+void generate_quiets(const Position& pos, MoveList& list)   { generate<QUIETS>(pos, list); }
+
 /* --------------------------------------------------------
- *  Генерация ЛЕГАЛЬНЫХ ходов (отсеиваем шах своему королю)
+ *  Легален ли ход m в позиции pos (ход из TT или киллер —
+ *  он мог прийти из другой позиции). Как и генератор — без
+ *  make_move: по шахующим, связкам и атакам на поля короля
  * --------------------------------------------------------*/
-void generate_moves(const Position& pos, std::vector<Move>& legal)
+bool is_legal(const Position& pos, Move m)
 {
-    std::vector<Move> pseudo;
-    generate_pseudo(pos, pseudo); // сначала собрали все псевдолегальные
-
-    legal.clear();
-    Position nxt;
-    for (Move m : pseudo)
-    {
-        pos.make_move(m, nxt); // делаем ход
-        Side us = pos.stm; // сохраняем сторону чтобы найти короля в nxt
-        Square ksq = Square(lsb_index(nxt.bb[us][KING])); 
-        if (!nxt.attacked(ksq, nxt.stm)) // если после хода король не под шахом
-            legal.push_back(m); // добавляем в список легальных
+    const Side us = pos.stm;
+    const Side them = Side(us ^ 1);
+    const Square from = from_sq(m), to = to_sq(m);
+    const Bitboard occ = pos.occ_all;
+
+    if (!m || from == to || !(pos.occ[us] & one(from)) || (pos.occ[us] & one(to)))
+        return false;
+
+    const PieceType pt = pos.piece_on(from);
+    const Bitboard promoRank = (us == WHITE) ? RANK_8 : RANK_1;
+    const bool onPromo = (one(to) & promoRank) != 0;
+    const MoveType type = type_of(m);
+    if ((type == PROMOTION) != (pt == PAWN && onPromo)) return false;
+
+    const Square ksq = Square(lsb_index(pos.bb[us][KING]));
+    const Bitboard checkers = pos.attackers_to(ksq, occ) & pos.occ[them];
+
+    /* рокировка: те же условия, что в генераторе */
+    if (type == CASTLING) {
+        const Square home = (us == WHITE) ? E1 : E8;
+        if (pt != KING || from != home || checkers)
+            return false;
+        int right;
+        Bitboard path;
+        if (to == home + 2) {
+            right = (us == WHITE) ? WOO : BOO;
+            path = one(Square(home + 1)) | one(Square(home + 2));
+        }
+        else if (to == home - 2) {
+            right = (us == WHITE) ? WOOO : BOOO;
+            path = one(Square(home - 1)) | one(Square(home - 2)) | one(Square(home - 3));
+        }
+        else
+            return false;
+        return (pos.cr & right) && !(occ & path)
+            && !pos.attacked(Square((from + to) / 2), them) && !pos.attacked(to, them);
+    }
+    if (pt == KING && std::abs(to - from) == 2)         // рокировка без флага
+        return false;
+
+    if (type == EN_PASSANT) {
+        const Bitboard att = (us == WHITE) ? PawnAttW[from] : PawnAttB[from];
+        if (pt != PAWN || to != pos.ep || !(att & one(to)))
+            return false;
+        return ep_legal(pos, from, ksq);
     }
-}
 
+    Bitboard reach = 0;
+    switch (pt) {
+    case PAWN: {
+        const int up = (us == WHITE) ? 8 : -8;
+        const Bitboard att = (us == WHITE) ? PawnAttW[from] : PawnAttB[from];
+        const int rank = from >> 3;
+        if (to == from + up && !(occ & one(to)))
+            reach = one(to);
+        else if (to == from + 2 * up && rank == (us == WHITE ? 1 : 6)
+            && !(occ & (one(to) | one(Square(from + up)))))
+            reach = one(to);
+        else if (att & one(to) & pos.occ[us ^ 1])
+            reach = one(to);
+        break;
+    }
+    case KNIGHT: reach = KnightAtt[from]; break;
+    case BISHOP: reach = bishop_attacks(from, occ); break;
+    case ROOK:   reach = rook_attacks(from, occ); break;
+    case QUEEN:  reach = bishop_attacks(from, occ) | rook_attacks(from, occ); break;
+    case KING:   reach = KingAtt[from]; break;
+    default:     return false;
+    }
+    if (!(reach & one(to)))
+        return false;
+
+    /* псевдолегален; король — не на битое поле (сам себя от луча не закрывает) */
+    if (pt == KING)
+        return !(pos.attackers_to(to, occ ^ one(from)) & pos.occ[them]);
+
+    /* двойной шах — ходит только король; одинарный — побить или закрыться */
+    if (checkers) {
+        if (checkers & (checkers - 1))
+            return false;
+        if (!((checkers | BetweenBB[ksq][lsb_index(checkers)]) & one(to)))
+            return false;
+    }
 
+    /* связанная фигура — только вдоль линии связки */
+    return !(pinned_pieces(pos, ksq) & one(from)) || (LineBB[ksq][from] & one(to));
+}
@@ -1,6 +1,8 @@
-#pragma once
+﻿#pragma once
 #include "position.h"
 #include "move.h"
-#include <vector>
 
-void generate_moves(const Position& pos, std::vector<Move>& list);
\ No newline at end of file
+void generate_moves(const Position& pos, MoveList& list);    // все легальные ходы
+void generate_captures(const Position& pos, MoveList& list); // взятия, en-passant и превращения
+void generate_quiets(const Position& pos, MoveList& list);   // остальные, включая рокировку
+bool is_legal(const Position& pos, Move m);                  // проверка хода из TT / киллера
\ No newline at end of file
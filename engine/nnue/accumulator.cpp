@@ -0,0 +1,145 @@
+﻿// engine/nnue/accumulator.cpp
+#include "accumulator.h"
+#include "simd.h"
+
+#include "../bitboard.h"
+
+#include <cstring>
+
+namespace {
+
+    inline void push_piece(NNUE::DirtyPiece& dp, Side c, PieceType pt, Square from, Square to) {
+        dp.side[dp.count] = c;
+        dp.pt[dp.count] = pt;
+        dp.from[dp.count] = from;
+        dp.to[dp.count] = to;
+        ++dp.count;
+    }
+
+} // namespace
+
+
+void NNUE::AccumulatorStack::reset(const Position& root)
+{
+    /* сеть между поисками могла смениться — кэш начинаем с пустой доски */
+    for (auto& bySide : finny)
+        for (FinnyEntry& e : bySide) {
+            std::memcpy(e.acc, net().ftBias, sizeof(e.acc));
+            e.bb = {};
+        }
+
+    refresh_cached(root, WHITE, st[0].v[WHITE]);
+    refresh_cached(root, BLACK, st[0].v[BLACK]);
+    st[0].computed[WHITE] = st[0].computed[BLACK] = true;
+}
+
+void NNUE::AccumulatorStack::refresh_cached(const Position& pos, Side persp, int16_t* acc)
+{
+    Square ksq = Square(lsb_index(pos.bb[persp][KING]));
+    FinnyEntry& e = finny[ksq][persp];
+    const int16_t* w = net().ftWeights;
+
+    /* фигур не больше 30: и появившихся, и исчезнувших — не больше 30 */
+    const int16_t* add[32];
+    const int16_t* sub[32];
+    int nAdd = 0, nSub = 0;
+    for (int c = WHITE; c <= BLACK; ++c)
+        for (int pt = PAWN; pt < KING; ++pt) {
+            Bitboard now = pos.bb[c][pt], was = e.bb[c][pt];
+            for (Bitboard b = now & ~was; b; )
+                add[nAdd++] = w + size_t(feature_index(persp, ksq, Side(c), PieceType(pt), pop_lsb(b))) * L1;
+            for (Bitboard b = was & ~now; b; )
+                sub[nSub++] = w + size_t(feature_index(persp, ksq, Side(c), PieceType(pt), pop_lsb(b))) * L1;
+            e.bb[c][pt] = now;
+        }
+
+    Simd::kernels().update(e.acc, e.acc, add, nAdd, sub, nSub);
+    std::memcpy(acc, e.acc, sizeof(e.acc));
+}
+
+void NNUE::AccumulatorStack::make_move(int ply, const Position& pos, Move m)
+{
+    Accumulator& a = st[ply + 1];
+    a.computed[WHITE] = a.computed[BLACK] = false;
+
+    DirtyPiece& dp = a.dp;
+    dp.count = 0;
+    dp.kingMoved[WHITE] = dp.kingMoved[BLACK] = false;
+
+    Side us = pos.stm, them = Side(us ^ 1);
+    Square from = from_sq(m), to = to_sq(m);
+    PieceType pt = pos.piece_on(from);
+
+    /* взятие, в том числе на проходе */
+    PieceType captured = pos.piece_on(to);
+    if (captured != NO_PIECE)
+        push_piece(dp, them, captured, to, SQ_NONE);
+    else if (type_of(m) == EN_PASSANT)
+        push_piece(dp, them, PAWN, us == WHITE ? Square(to - 8) : Square(to + 8), SQ_NONE);
+
+    if (pt == KING) {
+        /* король не признак, но меняет индексы всей своей перспективы */
+        dp.kingMoved[us] = true;
+        if (type_of(m) == CASTLING) {
+            Square rf = to > from ? Square(to + 1) : Square(to - 2);
+            Square rt = to > from ? Square(to - 1) : Square(to + 1);
+            push_piece(dp, us, ROOK, rf, rt);
+        }
+    }
+    else if (type_of(m) == PROMOTION) {
+        push_piece(dp, us, PAWN, from, SQ_NONE);
+        push_piece(dp, us, PieceType(promo_of(m)), SQ_NONE, to);
+    }
+    else
+        push_piece(dp, us, pt, from, to);
+}
+
+void NNUE::AccumulatorStack::make_null(int ply)
+{
+    Accumulator& a = st[ply + 1];
+    a.computed[WHITE] = a.computed[BLACK] = false;
+    a.dp.count = 0;
+    a.dp.kingMoved[WHITE] = a.dp.kingMoved[BLACK] = false;
+}
+
+void NNUE::AccumulatorStack::update(int ply, Side persp, const Position& pos)
+{
+    /* ищем ближайшую посчитанную запись; ход короля по пути — только пересчёт */
+    int q = ply;
+    while (!st[q].computed[persp]) {
+        if (st[q].dp.kingMoved[persp]) {
+            refresh_cached(pos, persp, st[ply].v[persp]);
+            st[ply].computed[persp] = true;
+            return;
+        }
+        --q;
+    }
+
+    /* король стоит на месте с записи q — применяем изменения вперёд */
+    Square ksq = Square(lsb_index(pos.bb[persp][KING]));
+    const int16_t* w = net().ftWeights;
+    for (int r = q + 1; r <= ply; ++r) {
+        const int16_t* add[3];
+        const int16_t* sub[3];
+        int nAdd = 0, nSub = 0;
+
+        const DirtyPiece& dp = st[r].dp;
+        for (int i = 0; i < dp.count; ++i) {
+            if (dp.from[i] != SQ_NONE)
+                sub[nSub++] = w + size_t(feature_index(persp, ksq, dp.side[i], dp.pt[i], dp.from[i])) * L1;
+            if (dp.to[i] != SQ_NONE)
+                add[nAdd++] = w + size_t(feature_index(persp, ksq, dp.side[i], dp.pt[i], dp.to[i])) * L1;
+        }
+        Simd::kernels().update(st[r].v[persp], st[r - 1].v[persp], add, nAdd, sub, nSub);
+        st[r].computed[persp] = true;
+    }
+}
+
+int NNUE::AccumulatorStack::evaluate(int ply, const Position& pos)
+{
+    Accumulator& a = st[ply];
+    for (Side persp : { WHITE, BLACK })
+        if (!a.computed[persp])
+            update(ply, persp, pos);
+    return forward(a.v[pos.stm], a.v[pos.stm ^ 1]);
+}
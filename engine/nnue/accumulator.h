@@ -0,0 +1,56 @@
+﻿#pragma once
+#include "nnue.h"
+#include <array>
+
+namespace NNUE {
+
+    constexpr int STACK_SIZE = 128;      // с запасом больше MAX_PLY поиска
+
+    /* --- что поменял один ход в признаках ---
+       до 3 фигур: взятие + снятие пешки + новая фигура при превращении;
+       from == SQ_NONE — фигура появилась, to == SQ_NONE — исчезла */
+    struct DirtyPiece {
+        int       count = 0;
+        Side      side[3];
+        PieceType pt[3];
+        Square    from[3];
+        Square    to[3];
+        bool      kingMoved[2]{};        // для этой перспективы нужен полный пересчёт
+    };
+
+    /* --- Finny-таблица: последний аккумулятор для [поле короля][перспектива]
+       вместе с фигурами, для которых он посчитан. Пересчёт после хода
+       короля применяет только разницу с этими фигурами, а не все ~30 --- */
+    struct FinnyEntry {
+        alignas(64) int16_t acc[L1];
+        std::array<std::array<Bitboard, 6>, 2> bb{};
+    };
+
+    struct Accumulator {
+        alignas(64) int16_t v[2][L1];    // [перспектива][нейрон]
+        bool       computed[2]{};
+        DirtyPiece dp;                   // ход, который привёл к этой записи
+    };
+
+    /* --------------------------------------------------------
+     *  Стек аккумуляторов по ply: make_move только записывает
+     *  изменения, пересчёт ленивый — в evaluate, от ближайшей
+     *  посчитанной записи вниз по стеку. Узлы, срезанные до оценки,
+     *  не стоят ничего.
+     * --------------------------------------------------------*/
+    class AccumulatorStack {
+    public:
+        void reset(const Position& root);                    // запись 0 — полный пересчёт
+        void make_move(int ply, const Position& pos, Move m); // запись ply+1 = ply + ход m из pos
+        void make_null(int ply);                             // нулевой ход: признаки те же
+        int  evaluate(int ply, const Position& pos);         // pos — позиция на этом ply
+
+    private:
+        void update(int ply, Side persp, const Position& pos);
+        void refresh_cached(const Position& pos, Side persp, int16_t* acc);
+
+        Accumulator st[STACK_SIZE];
+        FinnyEntry  finny[64][2];        // свой у каждого потока, как и стек
+    };
+
+} // namespace NNUE
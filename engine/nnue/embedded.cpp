@@ -0,0 +1,43 @@
+﻿// engine/nnue/embedded.cpp — сеть по умолчанию внутри бинарника
+#include "nnue.h"
+
+#if defined(NNUE_EMBEDDED_FILE) && !defined(_MSC_VER)
+
+/* .incbin кладёт файл в .rodata как есть, с выравниванием 64:
+   сеть используется оттуда без копирования, как и отображённый файл */
+#if defined(__APPLE__)
+#define EMBED_SECTION ".const_data\n"
+#define EMBED_SYM(name) "_" #name
+#else
+#define EMBED_SECTION ".section .rodata\n"
+#define EMBED_SYM(name) #name
+#endif
+
+__asm__(
+    EMBED_SECTION
+    ".balign 64\n"
+    ".globl " EMBED_SYM(nnueEmbeddedBegin) "\n"
+    EMBED_SYM(nnueEmbeddedBegin) ":\n"
+    ".incbin \"" NNUE_EMBEDDED_FILE "\"\n"
+    ".globl " EMBED_SYM(nnueEmbeddedEnd) "\n"
+    EMBED_SYM(nnueEmbeddedEnd) ":\n"
+    ".byte 0\n"
+    ".text\n");
+
+extern "C" const char nnueEmbeddedBegin[];
+extern "C" const char nnueEmbeddedEnd[];
+
+std::pair<const char*, size_t> NNUE::embedded()
+{
+    return { nnueEmbeddedBegin, size_t(nnueEmbeddedEnd - nnueEmbeddedBegin) };
+}
+
+#else
+
+/* сеть не задана при сборке (или MSVC без .incbin) — только EvalFile */
+std::pair<const char*, size_t> NNUE::embedded()
+{
+    return { nullptr, 0 };
+}
+
+#endif
@@ -0,0 +1,226 @@
+﻿// engine/nnue/nnue.cpp
+#include "nnue.h"
+#include "simd.h"
+
+#include "../bitboard.h"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+    constexpr size_t align64(size_t n) { return (n + 63) & ~size_t(63); }
+
+    /* размеры секций файла в порядке полей Network */
+    constexpr size_t SECTION_BYTES[] = {
+        NNUE::L1 * sizeof(int16_t),
+        size_t(NNUE::INPUTS) * NNUE::L1 * sizeof(int16_t),
+        NNUE::L2 * sizeof(int32_t),
+        NNUE::L2 * 2 * NNUE::L1,
+        NNUE::L3 * sizeof(int32_t),
+        NNUE::L3 * NNUE::L2,
+        sizeof(int32_t),
+        NNUE::L3,
+    };
+
+    constexpr size_t payload_bytes() {
+        size_t n = 0;
+        for (size_t s : SECTION_BYTES) n += align64(s);
+        return n;
+    }
+
+    /* --------------------------------------------------------
+     *  Файл сети, отображённый в память только на чтение.
+     *  Веса берутся прямо из page cache без копирования:
+     *  старт не ждёт чтения 20 МБ, а процессы с одной сетью
+     *  делят одни и те же физические страницы.
+     * --------------------------------------------------------*/
+    class MappedFile {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile() { close(); }
+
+        bool open(const std::string& path) {
+            close();
+#if defined(_WIN32)
+            HANDLE f = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                                   OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (f == INVALID_HANDLE_VALUE) return false;
+            LARGE_INTEGER sz;
+            HANDLE m = GetFileSizeEx(f, &sz) && sz.QuadPart > 0
+                ? CreateFileMappingA(f, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+            CloseHandle(f);                       // отображение держит файл само
+            if (!m) return false;
+            void* p = MapViewOfFile(m, FILE_MAP_READ, 0, 0, 0);
+            CloseHandle(m);
+            if (!p) return false;
+            size_ = size_t(sz.QuadPart);
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) return false;
+            struct stat st;
+            void* p = fstat(fd, &st) == 0 && st.st_size > 0
+                ? mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0) : MAP_FAILED;
+            ::close(fd);
+            if (p == MAP_FAILED) return false;
+            size_ = size_t(st.st_size);
+#endif
+            data_ = static_cast<const char*>(p);
+            return true;
+        }
+
+        void close() {
+            if (!data_) return;
+#if defined(_WIN32)
+            UnmapViewOfFile(data_);
+#else
+            munmap(const_cast<char*>(data_), size_);
+#endif
+            data_ = nullptr;
+            size_ = 0;
+        }
+
+        void swap(MappedFile& o) {
+            std::swap(data_, o.data_);
+            std::swap(size_, o.size_);
+        }
+
+        const char* data() const { return data_; }
+        size_t      size() const { return size_; }
+
+    private:
+        const char* data_ = nullptr;
+        size_t      size_ = 0;
+    };
+
+    MappedFile  mapped;                          // текущая сеть с диска (пусто — встроенная)
+    NNUE::Network network{};
+    bool        isLoaded = false;
+    std::string netSource;
+
+    /* проверяем заголовок и раскладываем указатели по секциям прямо в data;
+       при ошибке текущая сеть не трогается */
+    bool bind(const char* data, size_t size) {
+        using namespace NNUE;
+        if (!data || size < sizeof(FileHeader) + payload_bytes()
+            || reinterpret_cast<uintptr_t>(data) % 64 != 0)     // SIMD-ядрам нужно выравнивание секций
+            return false;
+
+        FileHeader h;
+        std::memcpy(&h, data, sizeof(h));
+        if (std::memcmp(h.magic, FILE_MAGIC, 4) != 0 || h.version != FILE_VERSION
+            || h.inputs != uint32_t(INPUTS) || h.l1 != uint32_t(L1)
+            || h.l2 != uint32_t(L2) || h.l3 != uint32_t(L3))
+            return false;
+
+        const char* p = data + sizeof(FileHeader);
+        const void* sec[8];
+        for (int i = 0; i < 8; ++i) {
+            sec[i] = p;
+            p += align64(SECTION_BYTES[i]);
+        }
+        network.ftBias     = static_cast<const int16_t*>(sec[0]);
+        network.ftWeights  = static_cast<const int16_t*>(sec[1]);
+        network.l1Bias     = static_cast<const int32_t*>(sec[2]);
+        network.l1Weights  = static_cast<const int8_t*>(sec[3]);
+        network.l2Bias     = static_cast<const int32_t*>(sec[4]);
+        network.l2Weights  = static_cast<const int8_t*>(sec[5]);
+        network.outBias    = static_cast<const int32_t*>(sec[6]);
+        network.outWeights = static_cast<const int8_t*>(sec[7]);
+        return true;
+    }
+
+} // namespace
+
+
+bool NNUE::load(const std::string& path)
+{
+    MappedFile f;
+    if (f.open(path) && bind(f.data(), f.size())) {
+        mapped.swap(f);                          // старое отображение закроется вместе с f
+        netSource = path;
+        isLoaded = true;
+        return true;
+    }
+
+    /* имени по умолчанию на диске нет — берём сеть, вшитую в бинарник */
+    auto [data, size] = embedded();
+    if (path == DEFAULT_FILE && bind(data, size)) {
+        mapped.close();
+        netSource = "<embedded>";
+        isLoaded = true;
+        return true;
+    }
+    return false;
+}
+
+const std::string& NNUE::source()
+{
+    return netSource;
+}
+
+bool NNUE::loaded()
+{
+    return isLoaded;
+}
+
+const NNUE::Network& NNUE::net()
+{
+    return network;
+}
+
+void NNUE::refresh(const Position& pos, Side persp, int16_t* acc)
+{
+    /* собираем строки весов всех фигур и складываем за один проход */
+    const int16_t* rows[32];
+    int n = 0;
+    Square ksq = Square(lsb_index(pos.bb[persp][KING]));
+    for (int c = WHITE; c <= BLACK; ++c)
+        for (int pt = PAWN; pt < KING; ++pt) {
+            Bitboard b = pos.bb[c][pt];
+            while (b) {
+                int idx = feature_index(persp, ksq, Side(c), PieceType(pt), pop_lsb(b));
+                rows[n++] = network.ftWeights + size_t(idx) * L1;
+            }
+        }
+    Simd::kernels().update(acc, network.ftBias, rows, n, nullptr, 0);
+}
+
+int NNUE::forward(const int16_t* us, const int16_t* them)
+{
+    alignas(64) uint8_t in[2 * L1];
+    alignas(64) uint8_t h1[L2];
+    alignas(64) uint8_t h2[L3];
+
+    const Simd::Kernels& k = Simd::kernels();
+    k.clip(us, in);
+    k.clip(them, in + L1);
+    k.affine_relu(in, 2 * L1, network.l1Weights, network.l1Bias, h1, L2);
+    k.affine_relu(h1, L2, network.l2Weights, network.l2Bias, h2, L3);
+
+    int32_t out = network.outBias[0];
+    for (int i = 0; i < L3; ++i)
+        out += int32_t(network.outWeights[i]) * h2[i];
+    return out / OUTPUT_SCALE;
+}
+
+int NNUE::evaluate(const Position& pos)
+{
+    alignas(64) int16_t acc[2][L1];
+    refresh(pos, WHITE, acc[WHITE]);
+    refresh(pos, BLACK, acc[BLACK]);
+    return forward(acc[pos.stm], acc[pos.stm ^ 1]);
+}
@@ -0,0 +1,87 @@
+﻿#pragma once
+#include "../position.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+
+/* --------------------------------------------------------
+ *  NNUE: HalfKP, 2 x 256 -> 32 -> 32 -> 1
+ *
+ *  признак = (король своей стороны, не-королевская фигура, поле),
+ *  каждая сторона смотрит "от себя": у чёрных доска отражена.
+ *  Аккумулятор (выход первого слоя) ведётся инкрементально,
+ *  см. accumulator.h; остальные слои считаются на каждой оценке.
+ * --------------------------------------------------------*/
+namespace NNUE {
+
+    constexpr int KING_SQUARES = 64;
+    constexpr int PIECE_SQUARES = 10 * 64;                  // свои/чужие P N B R Q x 64 поля
+    constexpr int INPUTS = KING_SQUARES * PIECE_SQUARES;    // 40960
+
+    constexpr int L1 = 256;              // половина аккумулятора (одна перспектива)
+    constexpr int L2 = 32;
+    constexpr int L3 = 32;
+
+    constexpr int CLIP_MAX = 127;        // clipped ReLU: [0, 127] в uint8
+    constexpr int WEIGHT_SHIFT = 6;      // int8-веса скрытых слоёв в масштабе 64
+    constexpr int OUTPUT_SCALE = 16;     // выход сети / 16 = сотые пешки
+
+    constexpr const char* DEFAULT_FILE = "nn.nnue";   // значение EvalFile по умолчанию
+
+    constexpr char     FILE_MAGIC[4] = { 'M', 'N', 'U', 'E' };
+    constexpr uint32_t FILE_VERSION = 1;
+
+    /* --- файл сети ---
+       64-байтный заголовок, затем секции в порядке полей Network,
+       каждая начинается с границы 64 байт; числа little-endian.
+       Порядок весов — тот, в котором их читают SIMD-ядра
+       (строки по нейронам), поэтому файл используется как есть,
+       без копирования и перестановок при загрузке */
+    struct FileHeader {
+        char     magic[4];
+        uint32_t version;
+        uint32_t inputs, l1, l2, l3;     // архитектура обязана совпасть с нашей
+        uint32_t reserved[10];
+    };
+    static_assert(sizeof(FileHeader) == 64, "NNUE::FileHeader must stay 64 bytes");
+
+    /* указатели смотрят внутрь загруженного блока */
+    struct Network {
+        const int16_t* ftBias;           // [L1]
+        const int16_t* ftWeights;        // [INPUTS][L1]
+        const int32_t* l1Bias;           // [L2]
+        const int8_t*  l1Weights;        // [L2][2 * L1]
+        const int32_t* l2Bias;           // [L3]
+        const int8_t*  l2Weights;        // [L3][L2]
+        const int32_t* outBias;          // [1]
+        const int8_t*  outWeights;       // [L3]
+    };
+
+    /* отображает файл в память (mmap / MapViewOfFile); для DEFAULT_FILE,
+       которого нет на диске, берёт встроенную сеть.
+       false — файла нет или не та архитектура, прежняя сеть остаётся */
+    bool load(const std::string& path);
+    bool loaded();
+    const std::string& source();         // откуда сеть: путь или "<embedded>"
+
+    /* сеть, вшитая при сборке (NNUE_EMBED_FILE в CMake); {nullptr, 0} — нет */
+    std::pair<const char*, size_t> embedded();
+    const Network& net();
+
+    /* индекс признака фигуры (c, pt) на sq для перспективы persp при короле ksq */
+    inline int feature_index(Side persp, Square ksq, Side c, PieceType pt, Square sq) {
+        int flip = persp == WHITE ? 0 : 56;
+        return (ksq ^ flip) * PIECE_SQUARES + ((c != persp) * 5 + pt) * 64 + (sq ^ flip);
+    }
+
+    /* полный пересчёт аккумулятора одной перспективы */
+    void refresh(const Position& pos, Side persp, int16_t* acc);
+
+    /* слои после аккумулятора: us — аккумулятор стороны, что ходит */
+    int forward(const int16_t* us, const int16_t* them);
+
+    /* оценка без стека аккумуляторов (вне поиска) */
+    int evaluate(const Position& pos);
+
+} // namespace NNUE
@@ -0,0 +1,104 @@
+﻿// engine/nnue/simd.cpp
+#include "simd.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace {
+
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+
+    void cpuid(int leaf, int sub, unsigned r[4]) {
+#if defined(_MSC_VER)
+        int x[4];
+        __cpuidex(x, leaf, sub);
+        for (int i = 0; i < 4; ++i) r[i] = unsigned(x[i]);
+#else
+        __cpuid_count(leaf, sub, r[0], r[1], r[2], r[3]);
+#endif
+    }
+
+    /* какие регистры ОС сохраняет при переключении контекста */
+    uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+        return _xgetbv(0);
+#else
+        unsigned lo, hi;
+        __asm__ volatile("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+        return (uint64_t(hi) << 32) | lo;
+#endif
+    }
+
+    NNUE::Simd::Arch detect() {
+        using namespace NNUE::Simd;
+        unsigned r1[4], r7[4];
+        cpuid(0, 0, r1);
+        unsigned maxLeaf = r1[0];
+        cpuid(1, 0, r1);
+        if (maxLeaf >= 7) cpuid(7, 0, r7);
+        else r7[0] = r7[1] = r7[2] = r7[3] = 0;
+
+        bool ssse3   = r1[2] & (1u << 9);
+        bool osxsave = r1[2] & (1u << 27);
+        bool avx     = r1[2] & (1u << 28);
+        uint64_t xcr0 = osxsave ? xgetbv0() : 0;
+        bool ymmOs  = (xcr0 & 0x06) == 0x06;         // XMM + YMM
+        bool zmmOs  = (xcr0 & 0xE6) == 0xE6;         // + opmask, ZMM
+
+        bool avx2     = avx && ymmOs && (r7[1] & (1u << 5));
+        bool avx512   = zmmOs && (r7[1] & (1u << 16))      // F
+                               && (r7[1] & (1u << 30))      // BW
+                               && (r7[1] & (1u << 31))      // VL
+                               && (r7[2] & (1u << 11));     // VNNI
+
+        if (avx512 && avx2) return AVX512_VNNI;
+        if (avx2)           return AVX2;
+        if (ssse3)          return SSSE3;
+        return SCALAR;
+    }
+
+#else
+
+    NNUE::Simd::Arch detect() { return NNUE::Simd::SCALAR; }
+
+#endif
+
+    const NNUE::Simd::Kernels* table(NNUE::Simd::Arch a) {
+        using namespace NNUE::Simd;
+        switch (a) {
+        case AVX512_VNNI: return avx512_kernels();
+        case AVX2:        return avx2_kernels();
+        case SSSE3:       return ssse3_kernels();
+        default:          return scalar_kernels();
+        }
+    }
+
+} // namespace
+
+
+const NNUE::Simd::Kernels* NNUE::Simd::active = NNUE::Simd::scalar_kernels();
+
+NNUE::Simd::Arch NNUE::Simd::best_supported()
+{
+    /* процессор может уметь больше, чем собрано — спускаемся до собранного */
+    for (int a = detect(); a > SCALAR; --a)
+        if (table(Arch(a)))
+            return Arch(a);
+    return SCALAR;
+}
+
+void NNUE::Simd::init()
+{
+    active = table(best_supported());
+}
+
+bool NNUE::Simd::force(Arch a)
+{
+    if (a >= ARCH_NB || a > detect() || !table(a))
+        return false;
+    active = table(a);
+    return true;
+}
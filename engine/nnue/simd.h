@@ -0,0 +1,45 @@
+﻿#pragma once
+#include "nnue.h"
+#include <cstdint>
+
+/* --------------------------------------------------------
+ *  SIMD-ядра NNUE. Каждый вариант живёт в своём .cpp со своими
+ *  флагами компилятора (simd_*.cpp), сам движок собирается под
+ *  базовый x86-64. При старте CPUID выбирает лучший вариант,
+ *  который поддерживают процессор и ОС.
+ * --------------------------------------------------------*/
+namespace NNUE::Simd {
+
+    enum Arch : int { SCALAR, SSSE3, AVX2, AVX512_VNNI, ARCH_NB };
+
+    struct Kernels {
+        const char* name;
+
+        /* dst = src + сумма add[i] - сумма sub[i]; все строки по L1 x int16 */
+        void (*update)(int16_t* dst, const int16_t* src,
+                       const int16_t* const* add, int nAdd,
+                       const int16_t* const* sub, int nSub);
+
+        /* clipped ReLU аккумулятора: L1 x int16 -> uint8 в [0, 127] */
+        void (*clip)(const int16_t* acc, uint8_t* out);
+
+        /* out[o] = clamp((b[o] + w[o] . in) >> WEIGHT_SHIFT, 0, 127);
+           w — строки по inDim int8, inDim кратно 32 */
+        void (*affine_relu)(const uint8_t* in, int inDim, const int8_t* w,
+                            const int32_t* b, uint8_t* out, int outDim);
+    };
+
+    /* ядра из simd_*.cpp; nullptr — вариант не собран под эту платформу */
+    const Kernels* scalar_kernels();
+    const Kernels* ssse3_kernels();
+    const Kernels* avx2_kernels();
+    const Kernels* avx512_kernels();
+
+    void init();                         // CPUID -> лучший доступный вариант
+    bool force(Arch a);                  // для тестов и сравнения; false — недоступен
+    Arch best_supported();
+
+    extern const Kernels* active;        // выбранные ядра, задаёт init()
+    inline const Kernels& kernels() { return *active; }
+
+} // namespace NNUE::Simd
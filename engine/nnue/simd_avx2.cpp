@@ -0,0 +1,77 @@
+﻿// engine/nnue/simd_avx2.cpp — 256 бит, собирается с -mavx2
+#include "simd.h"
+
+#if defined(__AVX2__)
+
+#include <algorithm>
+#include <immintrin.h>
+
+namespace {
+
+    using namespace NNUE;
+
+    constexpr int LANES = 16;            // int16 в регистре
+    constexpr int TILE = 8;              // 128 нейронов за проход, половина ymm под слагаемые
+
+    void update(int16_t* dst, const int16_t* src,
+                const int16_t* const* add, int nAdd,
+                const int16_t* const* sub, int nSub) {
+        for (int t = 0; t < L1; t += LANES * TILE) {
+            __m256i r[TILE];
+            for (int j = 0; j < TILE; ++j)
+                r[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + t + j * LANES));
+            for (int k = 0; k < nAdd; ++k)
+                for (int j = 0; j < TILE; ++j)
+                    r[j] = _mm256_add_epi16(r[j], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(add[k] + t + j * LANES)));
+            for (int k = 0; k < nSub; ++k)
+                for (int j = 0; j < TILE; ++j)
+                    r[j] = _mm256_sub_epi16(r[j], _mm256_loadu_si256(reinterpret_cast<const __m256i*>(sub[k] + t + j * LANES)));
+            for (int j = 0; j < TILE; ++j)
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + t + j * LANES), r[j]);
+        }
+    }
+
+    void clip(const int16_t* acc, uint8_t* out) {
+        const __m256i maxv = _mm256_set1_epi8(CLIP_MAX);
+        for (int i = 0; i < L1; i += 2 * LANES) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(acc + i + LANES));
+            /* packus пакует по 128-битным половинам: a0 b0 a1 b1 -> a0 a1 b0 b1 */
+            __m256i p = _mm256_permute4x64_epi64(_mm256_packus_epi16(a, b), _MM_SHUFFLE(3, 1, 2, 0));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_min_epu8(p, maxv));
+        }
+    }
+
+    inline int32_t hsum(__m256i v) {
+        __m128i x = _mm_add_epi32(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+        x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+        x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(x);
+    }
+
+    void affine_relu(const uint8_t* in, int inDim, const int8_t* w,
+                     const int32_t* b, uint8_t* out, int outDim) {
+        const __m256i ones = _mm256_set1_epi16(1);
+        for (int o = 0; o < outDim; ++o) {
+            const int8_t* row = w + o * inDim;
+            __m256i sum = _mm256_setzero_si256();
+            for (int i = 0; i < inDim; i += 32) {
+                __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+                __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+                sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(x, y), ones));
+            }
+            out[o] = uint8_t(std::clamp((b[o] + hsum(sum)) >> WEIGHT_SHIFT, 0, CLIP_MAX));
+        }
+    }
+
+    const Simd::Kernels KERNELS = { "avx2", update, clip, affine_relu };
+
+} // namespace
+
+const NNUE::Simd::Kernels* NNUE::Simd::avx2_kernels() { return &KERNELS; }
+
+#else
+
+const NNUE::Simd::Kernels* NNUE::Simd::avx2_kernels() { return nullptr; }
+
+#endif
@@ -0,0 +1,78 @@
+﻿// engine/nnue/simd_avx512.cpp — 512 бит + VNNI (vpdpbusd), собирается с -mavx512f -mavx512bw -mavx512vl -mavx512vnni
+#include "simd.h"
+
+#if defined(__AVX512F__) && defined(__AVX512BW__) && defined(__AVX512VL__) && defined(__AVX512VNNI__)
+
+#include <algorithm>
+#include <immintrin.h>
+
+namespace {
+
+    using namespace NNUE;
+
+    constexpr int LANES = 32;            // int16 в регистре
+    constexpr int TILE = L1 / LANES;     // весь аккумулятор (8 zmm) за один проход
+
+    void update(int16_t* dst, const int16_t* src,
+                const int16_t* const* add, int nAdd,
+                const int16_t* const* sub, int nSub) {
+        __m512i r[TILE];
+        for (int j = 0; j < TILE; ++j)
+            r[j] = _mm512_loadu_si512(src + j * LANES);
+        for (int k = 0; k < nAdd; ++k)
+            for (int j = 0; j < TILE; ++j)
+                r[j] = _mm512_add_epi16(r[j], _mm512_loadu_si512(add[k] + j * LANES));
+        for (int k = 0; k < nSub; ++k)
+            for (int j = 0; j < TILE; ++j)
+                r[j] = _mm512_sub_epi16(r[j], _mm512_loadu_si512(sub[k] + j * LANES));
+        for (int j = 0; j < TILE; ++j)
+            _mm512_storeu_si512(dst + j * LANES, r[j]);
+    }
+
+    void clip(const int16_t* acc, uint8_t* out) {
+        const __m512i maxv = _mm512_set1_epi8(CLIP_MAX);
+        const __m512i order = _mm512_setr_epi64(0, 2, 4, 6, 1, 3, 5, 7);
+        for (int i = 0; i < L1; i += 2 * LANES) {
+            __m512i a = _mm512_loadu_si512(acc + i);
+            __m512i b = _mm512_loadu_si512(acc + i + LANES);
+            /* packus пакует по 128-битным четвертям — возвращаем порядок */
+            __m512i p = _mm512_permutexvar_epi64(order, _mm512_packus_epi16(a, b));
+            _mm512_storeu_si512(out + i, _mm512_min_epu8(p, maxv));
+        }
+    }
+
+    void affine_relu(const uint8_t* in, int inDim, const int8_t* w,
+                     const int32_t* b, uint8_t* out, int outDim) {
+        for (int o = 0; o < outDim; ++o) {
+            const int8_t* row = w + o * inDim;
+            __m512i sum = _mm512_setzero_si512();
+            int i = 0;
+            for (; i + 64 <= inDim; i += 64)
+                sum = _mm512_dpbusd_epi32(sum, _mm512_loadu_si512(in + i), _mm512_loadu_si512(row + i));
+            int32_t s = _mm512_reduce_add_epi32(sum);
+
+            /* хвост в 32 байта (второй скрытый слой) — 256-битный VNNI */
+            if (i < inDim) {
+                __m256i t = _mm256_dpbusd_epi32(_mm256_setzero_si256(),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i)),
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i)));
+                __m128i x = _mm_add_epi32(_mm256_castsi256_si128(t), _mm256_extracti128_si256(t, 1));
+                x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(1, 0, 3, 2)));
+                x = _mm_add_epi32(x, _mm_shuffle_epi32(x, _MM_SHUFFLE(2, 3, 0, 1)));
+                s += _mm_cvtsi128_si32(x);
+            }
+            out[o] = uint8_t(std::clamp((b[o] + s) >> WEIGHT_SHIFT, 0, CLIP_MAX));
+        }
+    }
+
+    const Simd::Kernels KERNELS = { "avx512vnni", update, clip, affine_relu };
+
+} // namespace
+
+const NNUE::Simd::Kernels* NNUE::Simd::avx512_kernels() { return &KERNELS; }
+
+#else
+
+const NNUE::Simd::Kernels* NNUE::Simd::avx512_kernels() { return nullptr; }
+
+#endif
@@ -0,0 +1,41 @@
+﻿// engine/nnue/simd_scalar.cpp — без SIMD, работает везде
+#include "simd.h"
+
+#include <algorithm>
+
+namespace {
+
+    using namespace NNUE;
+
+    void update(int16_t* dst, const int16_t* src,
+                const int16_t* const* add, int nAdd,
+                const int16_t* const* sub, int nSub) {
+        for (int i = 0; i < L1; ++i) {
+            int16_t v = src[i];
+            for (int k = 0; k < nAdd; ++k) v += add[k][i];
+            for (int k = 0; k < nSub; ++k) v -= sub[k][i];
+            dst[i] = v;
+        }
+    }
+
+    void clip(const int16_t* acc, uint8_t* out) {
+        for (int i = 0; i < L1; ++i)
+            out[i] = uint8_t(std::clamp<int>(acc[i], 0, CLIP_MAX));
+    }
+
+    void affine_relu(const uint8_t* in, int inDim, const int8_t* w,
+                     const int32_t* b, uint8_t* out, int outDim) {
+        for (int o = 0; o < outDim; ++o) {
+            const int8_t* row = w + o * inDim;
+            int32_t sum = b[o];
+            for (int i = 0; i < inDim; ++i)
+                sum += int32_t(row[i]) * in[i];
+            out[o] = uint8_t(std::clamp(sum >> WEIGHT_SHIFT, 0, CLIP_MAX));
+        }
+    }
+
+    const Simd::Kernels KERNELS = { "scalar", update, clip, affine_relu };
+
+} // namespace
+
+const NNUE::Simd::Kernels* NNUE::Simd::scalar_kernels() { return &KERNELS; }
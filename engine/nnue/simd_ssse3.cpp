@@ -0,0 +1,76 @@
+﻿// engine/nnue/simd_ssse3.cpp — 128 бит, собирается с -mssse3
+#include "simd.h"
+
+#if defined(__SSSE3__) || (defined(_MSC_VER) && defined(_M_X64))
+
+#include <algorithm>
+#include <tmmintrin.h>
+
+namespace {
+
+    using namespace NNUE;
+
+    constexpr int LANES = 8;             // int16 в регистре
+    constexpr int TILE = 8;              // регистров на плитку: 64 нейрона за проход
+
+    void update(int16_t* dst, const int16_t* src,
+                const int16_t* const* add, int nAdd,
+                const int16_t* const* sub, int nSub) {
+        for (int t = 0; t < L1; t += LANES * TILE) {
+            __m128i r[TILE];
+            for (int j = 0; j < TILE; ++j)
+                r[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + t + j * LANES));
+            for (int k = 0; k < nAdd; ++k)
+                for (int j = 0; j < TILE; ++j)
+                    r[j] = _mm_add_epi16(r[j], _mm_loadu_si128(reinterpret_cast<const __m128i*>(add[k] + t + j * LANES)));
+            for (int k = 0; k < nSub; ++k)
+                for (int j = 0; j < TILE; ++j)
+                    r[j] = _mm_sub_epi16(r[j], _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub[k] + t + j * LANES)));
+            for (int j = 0; j < TILE; ++j)
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + t + j * LANES), r[j]);
+        }
+    }
+
+    void clip(const int16_t* acc, uint8_t* out) {
+        const __m128i maxv = _mm_set1_epi8(CLIP_MAX);
+        for (int i = 0; i < L1; i += 2 * LANES) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(acc + i + LANES));
+            __m128i p = _mm_min_epu8(_mm_packus_epi16(a, b), maxv);   // packus уже отрезал < 0
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), p);
+        }
+    }
+
+    inline int32_t hsum(__m128i v) {
+        v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+        v = _mm_add_epi32(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtsi128_si32(v);
+    }
+
+    void affine_relu(const uint8_t* in, int inDim, const int8_t* w,
+                     const int32_t* b, uint8_t* out, int outDim) {
+        const __m128i ones = _mm_set1_epi16(1);
+        for (int o = 0; o < outDim; ++o) {
+            const int8_t* row = w + o * inDim;
+            __m128i sum = _mm_setzero_si128();
+            for (int i = 0; i < inDim; i += 16) {
+                __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+                /* u8 x i8 -> пары int16 (вход <= 127 — без насыщения) -> int32 */
+                sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(x, y), ones));
+            }
+            out[o] = uint8_t(std::clamp((b[o] + hsum(sum)) >> WEIGHT_SHIFT, 0, CLIP_MAX));
+        }
+    }
+
+    const Simd::Kernels KERNELS = { "ssse3", update, clip, affine_relu };
+
+} // namespace
+
+const NNUE::Simd::Kernels* NNUE::Simd::ssse3_kernels() { return &KERNELS; }
+
+#else
+
+const NNUE::Simd::Kernels* NNUE::Simd::ssse3_kernels() { return nullptr; }
+
+#endif
@@ -1,21 +1,148 @@
 #pragma once
 #include "move.h"
+#include "movegen.h"
 #include "position.h"
+#include <utility>
 
 inline int move_score(const Position& pos, Move m)
 {
-    Square to = to_sq(m); //   
+    Square to = to_sq(m); // извлекаем целевой квадрат
 
-    /* ? */
+    /* захват? */
     if (pos.occ[pos.stm ^ 1] & one(to)) 
     {
-        /*      */
-        PieceType attacker = NO_PIECE, victim = NO_PIECE;
-        for (int t = 0; t < 6; ++t) {
-            if (pos.bb[pos.stm][t] & one(from_sq(m))) attacker = (PieceType)t;
-            if (pos.bb[pos.stm ^ 1][t] & one(to))     victim = (PieceType)t;
+        /* нападающая и бьющая фигуры — прямо из mailbox */
+        PieceType attacker = pos.piece_on(from_sq(m));
+        PieceType victim = pos.piece_on(to);
+        return 10'000 + mvv_lva_score(victim, attacker); // захваты всегда старше
+    }
+    return 0;  // обычный ход
+}
+
+/* сортировка вставками по убыванию score: устойчивая и без
+   временного буфера (std::stable_sort берёт память из кучи) */
+inline void sort_moves(ExtMove* begin, ExtMove* end)
+{
+    for (ExtMove* p = begin + 1; p < end; ++p) {
+        ExtMove tmp = *p;
+        ExtMove* q = p;
+        for (; q != begin && (q - 1)->score < tmp.score; --q)
+            *q = *(q - 1);
+        *q = tmp;
+    }
+}
+
+/*-------------------------------------------------------------
+   MovePicker — ходы по стадиям, следующая стадия генерируется
+   только если поиск до неё дошёл (отсечение на ходе из TT или
+   первом взятии обходится без генерации тихих):
+   ход из TT -> выгодные взятия (MVV/LVA, выбором) -> киллеры ->
+   тихие (по hist) -> проигрывающие по SEE взятия.
+   В квисенсии — только взятия и превращения, проигрывающие по SEE выбрасываются.
+ *------------------------------------------------------------*/
+class MovePicker {
+
+   public:
+    MovePicker(const Position& p, Move tt, const Move* killers, const int (*history)[64]) :
+        pos(p), ttMove(tt), hist(history), stage(TT_MOVE) {
+        killer[0] = killers[0];
+        killer[1] = killers[1];
+    }
+    explicit MovePicker(const Position& p) :                // квисенсия
+        pos(p), stage(GEN_CAPTURES), qsearch(true) {}
+
+    Move next()   // 0 — ходы кончились
+    {
+        switch (stage)
+        {
+        case TT_MOVE:
+            stage = GEN_CAPTURES;
+            if (ttMove && is_legal(pos, ttMove))
+                return ttMove;
+            ttMove = 0;
+            [[fallthrough]];
+
+        case GEN_CAPTURES:
+            generate_captures(pos, list);
+            for (ExtMove& em : list)
+                em.score = move_score(pos, em);
+            cur = list.begin();
+            stage = CAPTURES;
+            [[fallthrough]];
+
+        case CAPTURES:
+            while (cur < list.end()) {
+                /* выбором: лучший из оставшихся — вперёд */
+                ExtMove* best = cur;
+                for (ExtMove* p = cur + 1; p < list.end(); ++p)
+                    if (p->score > best->score) best = p;
+                std::swap(*cur, *best);
+                Move m = *cur++;
+                if (m == ttMove) continue;
+                if (pos.see_ge(m, 0)) return m;
+                if (!qsearch) bad.push_back(m);   // проигрывающее взятие — в самый конец
+            }
+            if (qsearch) { stage = DONE; return 0; }
+            stage = KILLER1;
+            [[fallthrough]];
+
+        case KILLER1:
+        case KILLER2:
+            while (stage != GEN_QUIETS) {
+                Move k = killer[stage - KILLER1];
+                stage = Stage(stage + 1);
+                if (k && k != ttMove && is_quiet(k) && is_legal(pos, k))
+                    return k;
+            }
+            [[fallthrough]];
+
+        case GEN_QUIETS:
+            generate_quiets(pos, list);
+            for (ExtMove& em : list)
+                em.score = hist[from_sq(em)][to_sq(em)];
+            sort_moves(list.begin(), list.end());
+            cur = list.begin();
+            stage = QUIETS;
+            [[fallthrough]];
+
+        case QUIETS:
+            while (cur < list.end()) {
+                Move m = *cur++;
+                if (m != ttMove && m != killer[0] && m != killer[1])
+                    return m;
+            }
+            cur = bad.begin();
+            stage = BAD_CAPTURES;
+            [[fallthrough]];
+
+        case BAD_CAPTURES:
+            if (cur < bad.end())
+                return *cur++;
+            stage = DONE;
+            [[fallthrough]];
+
+        case DONE:
+            break;
         }
-        return 10'000 + mvv_lva_score(victim, attacker); //   
+        return 0;
     }
-    return 0;  //  
-}
\ No newline at end of file
+
+   private:
+    enum Stage { TT_MOVE, GEN_CAPTURES, CAPTURES, KILLER1, KILLER2, GEN_QUIETS, QUIETS, BAD_CAPTURES, DONE };
+
+    /* киллер должен попасть в стадию тихих: не взятие, не превращение, не en-passant */
+    bool is_quiet(Move m) const {
+        return !(pos.occ_all & one(to_sq(m)))
+            && type_of(m) != PROMOTION && type_of(m) != EN_PASSANT;
+    }
+
+    const Position&  pos;
+    Move             ttMove = 0;
+    Move             killer[2]{};
+    const int        (*hist)[64] = nullptr;
+    Stage            stage;
+    bool             qsearch = false;
+    MoveList         list;
+    MoveList         bad;                 // взятия с SEE < 0, порядок MVV/LVA сохраняется
+    ExtMove*         cur = nullptr;
+};
\ No newline at end of file
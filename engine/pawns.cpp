@@ -0,0 +1,73 @@
+﻿// engine/pawns.cpp
+#include "pawns.h"
+
+#include "bitboard.h"
+#include "move.h"
+
+namespace {
+
+    constexpr Bitboard NOT_A = ~FILE_A;
+    constexpr Bitboard NOT_H = ~FILE_H;
+
+    constexpr Score DOUBLED  = make_score(-10, -20);
+    constexpr Score ISOLATED = make_score(-10, -15);
+    /* проходная по относительной горизонтали (1..8) */
+    constexpr Score PASSED[8] = {
+        make_score(0, 0),   make_score(5, 10),  make_score(5, 15),  make_score(10, 25),
+        make_score(20, 45), make_score(35, 75), make_score(55, 110), make_score(0, 0)
+    };
+
+    inline Bitboard east(Bitboard b)  { return (b << 1) & NOT_A; }
+    inline Bitboard west(Bitboard b)  { return (b >> 1) & NOT_H; }
+    inline Bitboard north_fill(Bitboard b) {
+        b |= b << 8; b |= b << 16; b |= b << 32;
+        return b;
+    }
+    inline Bitboard south_fill(Bitboard b) {
+        b |= b >> 8; b |= b >> 16; b |= b >> 32;
+        return b;
+    }
+    /* поля строго впереди пешек стороны c */
+    inline Bitboard front_span(Side c, Bitboard b) {
+        return c == WHITE ? north_fill(b) << 8 : south_fill(b) >> 8;
+    }
+
+    /* оценка пешек одной стороны, заполняет поля записи для c */
+    Score evaluate_side(Side c, const Position& pos, Pawns::Entry& e)
+    {
+        Side them = Side(c ^ 1);
+        Bitboard ours = pos.bb[c][PAWN];
+        Bitboard theirs = pos.bb[them][PAWN];
+
+        Bitboard theirSpan = front_span(them, theirs);
+        Bitboard theirAttackSpan = east(theirSpan) | west(theirSpan);
+        Bitboard ourSpan = front_span(c, ours);
+        Bitboard files = north_fill(ours) | south_fill(ours);
+
+        e.attacks[c] = c == WHITE ? east(ours << 8) | west(ours << 8)
+                                  : east(ours >> 8) | west(ours >> 8);
+        e.attackSpan[c] = east(ourSpan) | west(ourSpan);
+        e.passed[c] = ours & ~(theirSpan | theirAttackSpan);
+
+        Score s = 0;
+        s += DOUBLED * popcount(ours & ourSpan);              // спереди своя пешка — задняя сдвоена
+        s += ISOLATED * popcount(ours & ~(east(files) | west(files)));
+        for (Bitboard b = e.passed[c]; b; ) {
+            int rank = pop_lsb(b) >> 3;
+            s += PASSED[c == WHITE ? rank : 7 - rank];
+        }
+        return s;
+    }
+
+} // namespace
+
+const Pawns::Entry* Pawns::Table::probe(const Position& pos)
+{
+    Entry& e = entries[pos.pawnKey & (TABLE_SIZE - 1)];
+    if (e.key == pos.pawnKey)
+        return &e;
+
+    e.key = pos.pawnKey;
+    e.score = evaluate_side(WHITE, pos, e) - evaluate_side(BLACK, pos, e);
+    return &e;
+}
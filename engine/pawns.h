@@ -0,0 +1,36 @@
+﻿#pragma once
+#include "position.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/* --------------------------------------------------------
+ *  Пешечная структура: проходные, изолированные, сдвоенные.
+ *  Пешки двигаются редко, поэтому результат кэшируется
+ *  по Position::pawnKey (Zobrist только по пешкам).
+ *  Таблица своя у каждого потока поиска — без блокировок.
+ * --------------------------------------------------------*/
+namespace Pawns {
+
+    constexpr size_t TABLE_SIZE = 16384;         // записей, степень 2 (1 МБ)
+
+    struct Entry {
+        uint64_t key = 0;
+        Score    score = 0;                      // (mg, eg) с точки зрения белых
+        Bitboard passed[2]{};                    // проходные пешки
+        Bitboard attacks[2]{};                   // поля, которые бьют пешки
+        Bitboard attackSpan[2]{};                // всё, что пешки смогут бить, продвигаясь
+    };
+
+    class Table {
+    public:
+        Table() : entries(TABLE_SIZE) {}
+
+        /* запись для пешек позиции: из кэша или посчитанная заново */
+        const Entry* probe(const Position& pos);
+
+    private:
+        std::vector<Entry> entries;
+    };
+
+} // namespace
@@ -0,0 +1,25 @@
+﻿#pragma once
+#include "position.h"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+constexpr size_t PERFT_HASH_MB = 64;     // отдельная от TT таблица (ключ, глубина) → узлы
+
+/* --------------------------------------------------------
+ *  perft: число листьев на глубине depth
+ *  корневые ходы делятся между threads потоками,
+ *  поддеревья кэшируются в lock-free хэше, на глубине 1
+ *  листья считаются по размеру списка ходов (bulk counting).
+ *  divide = true — печатает счёт по каждому корневому ходу.
+ *  hashed = false — без хэша, чистая скорость генератора.
+ * --------------------------------------------------------*/
+uint64_t perft(const Position& pos, int depth, int threads = 1, bool divide = false, bool hashed = true);
+
+/* --------------------------------------------------------
+ *  perftsuite: EPD вида  <fen> ;D1 20 ;D2 400 ...
+ *  (FEN из 4 или 6 полей). Каждую позицию гоняем до maxDepth
+ *  (0 = все глубины из файла) без хэша, печатаем время и Mnps
+ *  по позиции и итог. Возвращает число несовпадений, -1 — нет файла.
+ * --------------------------------------------------------*/
+int perft_suite(const std::string& file, int maxDepth, int threads = 1);
@@ -1,24 +1,30 @@
 #include "position.h"
 #include "bitboard.h"
 #include "move.h"
+#include <algorithm>
+#include <cctype>
+#include <charconv>
+#include <iostream>
 #include <sstream> 
 #include "magic.h"
+#include "zobrist.h"
+#include "psqt.h"
 
 
-/*     sq? */
+/* атакует ли сторона поле sq? */
 bool Position::attacked(Square sq, Side by) const {
-    // 
+    // пешки
     if (by == WHITE && (PawnAttB[sq] & bb[WHITE][PAWN])) return true;
     if (by == BLACK && (PawnAttW[sq] & bb[BLACK][PAWN])) return true;
-    //  / 
+    // кони / король
     if (KnightAtt[sq] & bb[by][KNIGHT]) return true;
     if (KingAtt[sq] & bb[by][KING])   return true;
 
     Bitboard occ = occ_all;
-    //  /   
+    // слон / ферзь по диагонали
     if (bishop_attacks(sq, occ) & (bb[by][BISHOP] | bb[by][QUEEN]))
         return true;
-    //  /   
+    // ладья / ферзь по прямой
     if (rook_attacks(sq, occ) & (bb[by][ROOK] | bb[by][QUEEN]))
         return true;
 
@@ -27,114 +33,310 @@ bool Position::attacked(Square sq, Side by) const {
 
 
 
-/*----------   ( unmake) ----------*/
-void Position::make_move(Move m, Position& nxt) const
+/* кто (обе стороны) бьёт поле sq при заданной занятости occ */
+Bitboard Position::attackers_to(Square sq, Bitboard occ) const {
+    return (PawnAttB[sq] & bb[WHITE][PAWN])
+        | (PawnAttW[sq] & bb[BLACK][PAWN])
+        | (KnightAtt[sq] & (bb[WHITE][KNIGHT] | bb[BLACK][KNIGHT]))
+        | (KingAtt[sq] & (bb[WHITE][KING] | bb[BLACK][KING]))
+        | (bishop_attacks(sq, occ) & (bb[WHITE][BISHOP] | bb[BLACK][BISHOP] | bb[WHITE][QUEEN] | bb[BLACK][QUEEN]))
+        | (rook_attacks(sq, occ) & (bb[WHITE][ROOK] | bb[BLACK][ROOK] | bb[WHITE][QUEEN] | bb[BLACK][QUEEN]));
+}
+
+/* ------------------------------------------------------------
+ *  SEE — Static Exchange Evaluation: разменная серия на поле to,
+ *  каждая сторона бьёт самой дешёвой фигурой, после хода слайдера
+ *  открываются фигуры за ним (рентген). Связки не учитываются.
+ *  Возвращает, не хуже ли результат для нас, чем threshold.
+ * ------------------------------------------------------------*/
+static constexpr int SEE_VAL[7] = { 100, 320, 330, 500, 900, 0, 0 }; // король и пусто — 0
+
+bool Position::see_ge(Move m, int threshold) const
 {
-    nxt = *this; // 
-    Square from = from_sq(m);
-    Square to = to_sq(m);
-    int promo = promo_of(m);
+    const Square from = from_sq(m), to = to_sq(m);
 
-    Side us = this->stm;
-    Side them = Side(us ^ 1);
+    /* превращение и en-passant не считаем — считаем равным размену */
+    if (type_of(m) == PROMOTION || type_of(m) == EN_PASSANT)
+        return 0 >= threshold;
 
-    /*   ,   from */
-    PieceType pt = NO_PIECE;
-    for (int t = 0; t < 6; ++t)
-        if (bb[us][t] & one(from)) { pt = PieceType(t); break; }
+    int swap = SEE_VAL[piece_on(to)] - threshold;
+    if (swap < 0)                    // даже бесплатное взятие не дотягивает
+        return false;
 
-    nxt.bb[us][pt] ^= one(from);
-    nxt.occ[us] ^= one(from);
+    swap = SEE_VAL[piece_on(from)] - swap;
+    if (swap <= 0)                   // даже если нашу фигуру съедят — порог взят
+        return true;
+
+    Bitboard occ = occ_all ^ one(from) ^ one(to);
+    Bitboard attackers = attackers_to(to, occ);
+    const Bitboard diag = bb[WHITE][BISHOP] | bb[BLACK][BISHOP] | bb[WHITE][QUEEN] | bb[BLACK][QUEEN];
+    const Bitboard orth = bb[WHITE][ROOK] | bb[BLACK][ROOK] | bb[WHITE][QUEEN] | bb[BLACK][QUEEN];
+
+    Side side = stm;
+    int res = 1;
+
+    while (true)
+    {
+        side = Side(side ^ 1);
+        attackers &= occ;           // уже побившие фигуры снимаем
 
-    /* ? */
-    for (int t = 0; t < 6; ++t)
-        if (nxt.bb[them][t] & one(to)) {
-            nxt.bb[them][t] ^= one(to);
-            nxt.occ[them] ^= one(to);
+        Bitboard sideAtt = attackers & this->occ[side];
+        if (!sideAtt)
             break;
-        }
-    /* ---        --- */
-    if (to == H1) nxt.cr &= ~WOO;
-    else if (to == A1) nxt.cr &= ~WOOO;
-    else if (to == H8) nxt.cr &= ~BOO;
-    else if (to == A8) nxt.cr &= ~BOOO;
-
-    /* en-passant  */
-    if (pt == PAWN && to == ep && ep != SQ_NONE) {
-        Square cap = (us == WHITE) ? Square(to - 8) : Square(to + 8);
-        nxt.bb[them][PAWN] ^= one(cap);
-        nxt.occ[them] ^= one(cap);
+        res ^= 1;
+
+        /* самая дешёвая фигура стороны side */
+        Bitboard b;
+        int pt = PAWN;
+        for (; pt < KING; ++pt)
+            if ((b = sideAtt & bb[side][pt]))
+                break;
+
+        if (pt == KING)              // бить королём можно, только если больше нечем ответить
+            return (attackers & this->occ[side ^ 1]) ? res ^ 1 : res;
+
+        if ((swap = SEE_VAL[pt] - swap) < res)
+            break;
+
+        occ ^= b & (0 - b);         // снимаем бившую фигуру
+        if (pt == PAWN || pt == BISHOP || pt == QUEEN)
+            attackers |= bishop_attacks(to, occ) & diag;
+        if (pt == ROOK || pt == QUEEN)
+            attackers |= rook_attacks(to, occ) & orth;
     }
+    return res != 0;
+}
 
-    /*    to */
-    PieceType final_pt = promo ? PieceType(promo) : pt;
-    nxt.bb[us][final_pt] |= one(to);
-    nxt.occ[us] |= one(to);
+/*---------- copy-make: копия + ход на копии ----------*/
+void Position::make_move(Move m, Position& nxt) const
+{
+    StateInfo st;
+    nxt = *this; // копия
+    nxt.do_move(m, st);
+}
+
+/*---------- ход на месте; что не восстановить по ходу — в st ----------*/
+void Position::do_move(Move m, StateInfo& st)
+{
+    st.key = key;
+    st.pawnKey = pawnKey;
+    st.psq = psq;
+    st.phase = phase;
+    st.cr = cr;
+    st.ep = ep;
+    st.rule50 = rule50;
+    st.pliesFromNull = pliesFromNull;
+    st.captured = NO_PIECE;
 
-    /*    */
-    nxt.occ_all = nxt.occ[WHITE] | nxt.occ[BLACK];
+    Square from = from_sq(m);
+    Square to = to_sq(m);
+    const MoveType type = type_of(m);
+
+    Side us = stm;
+    Side them = Side(us ^ 1);
+
+    /* тип фигуры берём из mailbox, снимаем с from */
+    PieceType pt = piece_on(from);
+
+    bb[us][pt] ^= one(from);
+    occ[us] ^= one(from);
+    board[from] = NO_PIECE;
+    key ^= Zobrist::R[us][pt][from];
+    psq -= PSQT::psq(us, pt, from);
+    if (pt == PAWN) pawnKey ^= Zobrist::R[us][PAWN][from];
+
+    /* взятие? */
+    PieceType captured = piece_on(to);
+    if (captured != NO_PIECE) {
+        st.captured = captured;
+        bb[them][captured] ^= one(to);
+        occ[them] ^= one(to);
+        key ^= Zobrist::R[them][captured][to];
+        psq -= PSQT::psq(them, captured, to);
+        if (captured == PAWN) pawnKey ^= Zobrist::R[them][PAWN][to];
+        phase -= PSQT::PHASE_INC[captured];
+    }
+    /* --- если съели угловую ладью делитаем право рокировки --- */
+    if (to == H1) cr &= ~WOO;
+    else if (to == A1) cr &= ~WOOO;
+    else if (to == H8) cr &= ~BOO;
+    else if (to == A8) cr &= ~BOOO;
+
+    /* en-passant взятие */
+    if (type == EN_PASSANT) {
+        st.captured = PAWN;
+        Square cap = (us == WHITE) ? Square(to - 8) : Square(to + 8);
+        bb[them][PAWN] ^= one(cap);
+        occ[them] ^= one(cap);
+        board[cap] = NO_PIECE;
+        key ^= Zobrist::R[them][PAWN][cap];
+        psq -= PSQT::psq(them, PAWN, cap);
+        pawnKey ^= Zobrist::R[them][PAWN][cap];
+    }
 
-    /*   */
+    /* поместить фигуру на to */
+    PieceType final_pt = type == PROMOTION ? PieceType(promo_of(m)) : pt;
+    bb[us][final_pt] |= one(to);
+    occ[us] |= one(to);
+    board[to] = uint8_t(final_pt);
+    key ^= Zobrist::R[us][final_pt][to];
+    psq += PSQT::psq(us, final_pt, to);
+    if (final_pt == PAWN) pawnKey ^= Zobrist::R[us][PAWN][to];
+    phase += PSQT::PHASE_INC[final_pt] - PSQT::PHASE_INC[pt];
+
+    /* рокировочные права */
     if (pt == KING) {
-        nxt.cr &= (us == WHITE) ? ~(WOO | WOOO) : ~(BOO | BOOO);
-        /* :   */
-        if (from == E1 && to == G1) { nxt.bb[WHITE][ROOK] ^= one(H1) | one(F1); nxt.occ[WHITE] ^= one(H1) | one(F1); }
-        if (from == E1 && to == C1) { nxt.bb[WHITE][ROOK] ^= one(A1) | one(D1); nxt.occ[WHITE] ^= one(A1) | one(D1); }
-        if (from == E8 && to == G8) { nxt.bb[BLACK][ROOK] ^= one(H8) | one(F8); nxt.occ[BLACK] ^= one(H8) | one(F8); }
-        if (from == E8 && to == C8) { nxt.bb[BLACK][ROOK] ^= one(A8) | one(D8); nxt.occ[BLACK] ^= one(A8) | one(D8); }
+        cr &= (us == WHITE) ? ~(WOO | WOOO) : ~(BOO | BOOO);
+        /* рокировка: перемещаем ладью */
+        if (type == CASTLING) {
+            Square rf = to > from ? Square(to + 1) : Square(to - 2);
+            Square rt = to > from ? Square(to - 1) : Square(to + 1);
+            bb[us][ROOK] ^= one(rf) | one(rt);
+            occ[us] ^= one(rf) | one(rt);
+            board[rf] = NO_PIECE;
+            board[rt] = ROOK;
+            key ^= Zobrist::R[us][ROOK][rf] ^ Zobrist::R[us][ROOK][rt];
+            psq += PSQT::psq(us, ROOK, rt) - PSQT::psq(us, ROOK, rf);
+        }
     }
     if (pt == ROOK) {
-        if (from == H1) nxt.cr &= ~WOO;
-        if (from == A1) nxt.cr &= ~WOOO;
-        if (from == H8) nxt.cr &= ~BOO;
-        if (from == A8) nxt.cr &= ~BOOO;
+        if (from == H1) cr &= ~WOO;
+        if (from == A1) cr &= ~WOOO;
+        if (from == H8) cr &= ~BOO;
+        if (from == A8) cr &= ~BOOO;
     }
 
-    /* en-passant  -------------------------------------------------- */
-    nxt.ep = SQ_NONE;
+    /* en-passant поле -------------------------------------------------- */
+    ep = SQ_NONE;
 
-    if (pt == PAWN && abs(to - from) == 16)         //  
+    if (pt == PAWN && abs(to - from) == 16)         // двойной шаг
     {
-        Square e = (us == WHITE) ? Square(from + 8)   // ,   
+        Square e = (us == WHITE) ? Square(from + 8)   // поле, через которое перепрыгнули
             : Square(from - 8);
 
         bool can_ep = false;
-        if (us == WHITE) {           //     d4/f4  e3  ..
-            if ((e & 7) != 0 && (nxt.bb[them][PAWN] & one(Square(e + 7)))) can_ep = true;
-            if ((e & 7) != 7 && (nxt.bb[them][PAWN] & one(Square(e + 9)))) can_ep = true;
+        if (us == WHITE) {           // смотрим ЧЕРНЫЕ пешки на d4/f4 против e3 и т.п.
+            if ((e & 7) != 0 && (bb[them][PAWN] & one(Square(e + 7)))) can_ep = true;
+            if ((e & 7) != 7 && (bb[them][PAWN] & one(Square(e + 9)))) can_ep = true;
         }
-        else {                       //  :     d5/f5  e6
-            if ((e & 7) != 7 && (nxt.bb[them][PAWN] & one(Square(e - 7)))) can_ep = true;
-            if ((e & 7) != 0 && (nxt.bb[them][PAWN] & one(Square(e - 9)))) can_ep = true;
+        else {                       // ходили черные: ищем БЕЛЫЕ пешки на d5/f5 против e6
+            if ((e & 7) != 7 && (bb[them][PAWN] & one(Square(e - 7)))) can_ep = true;
+            if ((e & 7) != 0 && (bb[them][PAWN] & one(Square(e - 9)))) can_ep = true;
         }
 
-        if (can_ep) nxt.ep = e;
+        if (can_ep) ep = e;
+    }
+
+    occ_all = occ[WHITE] | occ[BLACK];
+
+    /* ключ: рокировка, ep, сторона */
+    key ^= Zobrist::CASTLE[st.cr & 0xF] ^ Zobrist::CASTLE[cr & 0xF];
+    if (st.ep != SQ_NONE) key ^= Zobrist::EP[st.ep & 7];
+    if (ep != SQ_NONE)    key ^= Zobrist::EP[ep & 7];
+    key ^= Zobrist::SIDE;
+
+    /* взятие и ход пешкой необратимы — счётчик 50 ходов с нуля */
+    rule50 = (pt == PAWN || st.captured != NO_PIECE) ? 0 : rule50 + 1;
+    ++pliesFromNull;
+
+    /* смена хода */
+    stm = them;
+}
+
+/*---------- откат хода: фигуры двигаем обратно, остальное берём из st ----------*/
+void Position::undo_move(Move m, const StateInfo& st)
+{
+    Square from = from_sq(m);
+    Square to = to_sq(m);
+    Side them = stm;
+    Side us = Side(them ^ 1);
+
+    const MoveType type = type_of(m);
+    PieceType final_pt = piece_on(to);
+    PieceType pt = type == PROMOTION ? PAWN : final_pt;
+
+    /* фигура с to обратно на from */
+    bb[us][final_pt] ^= one(to);
+    bb[us][pt] ^= one(from);
+    occ[us] ^= one(to) | one(from);
+    board[to] = NO_PIECE;
+    board[from] = uint8_t(pt);
+
+    /* рокировка: ладья обратно */
+    if (type == CASTLING) {
+        Square rf = to > from ? Square(to + 1) : Square(to - 2);
+        Square rt = to > from ? Square(to - 1) : Square(to + 1);
+        bb[us][ROOK] ^= one(rf) | one(rt);
+        occ[us] ^= one(rf) | one(rt);
+        board[rt] = NO_PIECE;
+        board[rf] = ROOK;
     }
 
-    nxt.occ_all = nxt.occ[WHITE] | nxt.occ[BLACK];
+    /* взятая фигура: на to, либо (en-passant) за ним */
+    if (st.captured != NO_PIECE) {
+        Square cap = to;
+        if (type == EN_PASSANT)
+            cap = (us == WHITE) ? Square(to - 8) : Square(to + 8);
+        bb[them][st.captured] |= one(cap);
+        occ[them] |= one(cap);
+        board[cap] = uint8_t(st.captured);
+    }
+    occ_all = occ[WHITE] | occ[BLACK];
 
-    /*   */
-    nxt.stm = them;
+    key = st.key;
+    pawnKey = st.pawnKey;
+    psq = st.psq;
+    phase = st.phase;
+    cr = st.cr;
+    ep = st.ep;
+    rule50 = st.rule50;
+    pliesFromNull = st.pliesFromNull;
+    stm = us;
+}
+
+/*---------- нулевой ход: только сторона и ep. rule50 не трогаем — иначе
+   под нулевым ходом не видно ничьей по 50 ходам; повтор через нулевой ход
+   не настоящий, его поиск ограничивает pliesFromNull ----------*/
+void Position::do_null_move(StateInfo& st)
+{
+    st.key = key;
+    st.ep = ep;
+    st.pliesFromNull = pliesFromNull;
+    pliesFromNull = 0;
+    if (ep != SQ_NONE) key ^= Zobrist::EP[ep & 7];
+    key ^= Zobrist::SIDE;
+    ep = SQ_NONE;
+    stm = Side(stm ^ 1);
+}
+
+void Position::undo_null_move(const StateInfo& st)
+{
+    key = st.key;
+    ep = st.ep;
+    pliesFromNull = st.pliesFromNull;
+    stm = Side(stm ^ 1);
 }
 
 /* ------------------------------------------------------------
- *  position_from_fen    FEN
- *   true,   
+ *  position_from_fen – парсер стандартного FEN
+ *  Возвращает true, если парсинг успешен
  * ------------------------------------------------------------*/
 bool position_from_fen(Position& p, const std::string& fen)
 {
-    Position tmp;  // 
-    tmp = Position();  // 
+    Position tmp;  // локальный
+    tmp = Position();  // обнуляем
     for (int c = 0; c < 2; ++c)
         for (int t = 0; t < 6; ++t)
             tmp.bb[c][t] = 0;
+    tmp.board.fill(NO_PIECE);
 
     std::istringstream ss(fen);
     std::string board, turn, castling, ep, halfmove, fullmove;
-    if (!(ss >> board >> turn >> castling >> ep >> halfmove >> fullmove))
-        return false;                       //  6 
+    if (!(ss >> board >> turn >> castling >> ep))
+        return false;                       // меньше 4 полей
+    ss >> halfmove >> fullmove;             // в EPD счётчиков ходов нет — не обязательны
 
-    /* -----------  1:   ----------- */
+    /* ----------- поле 1: расположение фигур ----------- */
     int sq = 56;                            // a8
     for (char ch : board)
     {
@@ -154,22 +356,23 @@ bool position_from_fen(Position& p, const std::string& fen)
         }
         if (sq < 0 || sq >= 64) return false;
         tmp.bb[color][pt] |= one(Square(sq));
+        tmp.board[sq] = uint8_t(pt);
         sq++;
     }
 
-    /* -----------  2: side to move ----------- */
+    /* ----------- поле 2: side to move ----------- */
     if (turn == "w") tmp.stm = WHITE;
     else if (turn == "b") tmp.stm = BLACK;
     else return false;
 
-    /* -----------  3: castling ----------- */
+    /* ----------- поле 3: castling ----------- */
     tmp.cr = 0;
     if (castling.find('K') != std::string::npos) tmp.cr |= WOO;
     if (castling.find('Q') != std::string::npos) tmp.cr |= WOOO;
     if (castling.find('k') != std::string::npos) tmp.cr |= BOO;
     if (castling.find('q') != std::string::npos) tmp.cr |= BOOO;
 
-    /* -----------  4: en-passant ----------- */
+    /* ----------- поле 4: en-passant ----------- */
     if (ep == "-") tmp.ep = SQ_NONE;
     else if (ep.size() == 2 &&
         ep[0] >= 'a' && ep[0] <= 'h' &&
@@ -181,15 +384,29 @@ bool position_from_fen(Position& p, const std::string& fen)
     }
     else return false;
 
-    /* -----------  occ / occ_all ----------- */
+    /* ----------- поле 5: полуходы для правила 50 ходов -----------
+       мусор или его нет (EPD) — 0, без исключений; больше 100 не бывает —
+       правило уже сработало, а rule50 ограничивает поиск повторов назад */
+    tmp.rule50 = 0;
+    tmp.pliesFromNull = 0;
+    int hm = 0;
+    auto [end, ec] = std::from_chars(halfmove.data(), halfmove.data() + halfmove.size(), hm);
+    (void)end;
+    if (ec == std::errc())
+        tmp.rule50 = std::clamp(hm, 0, 100);
+
+    /* ----------- пересчитываем occ / occ_all ----------- */
     tmp.occ[WHITE] = tmp.occ[BLACK] = 0;
     for (int t = 0; t < 6; ++t) {
         tmp.occ[WHITE] |= tmp.bb[WHITE][t];
         tmp.occ[BLACK] |= tmp.bb[BLACK][t];
     }
     tmp.occ_all = tmp.occ[WHITE] | tmp.occ[BLACK];
+    tmp.key = Zobrist::hash(tmp);
+    tmp.pawnKey = Zobrist::pawn_hash(tmp);
+    tmp.compute_psq();
 
-    /* ---       --- */
+    /* --- все прошло копируем во внешнюю позицию --- */
     p = tmp;
     return true;
 }
@@ -217,5 +434,55 @@ void Position::set_startpos()
         bb[BLACK][ROOK] | bb[BLACK][QUEEN] | bb[BLACK][KING];
 
     occ_all = occ[WHITE] | occ[BLACK];
+
+    board.fill(NO_PIECE);
+    for (int c = 0; c < 2; ++c)
+        for (int t = 0; t < 6; ++t) {
+            Bitboard b = bb[c][t];
+            while (b) board[pop_lsb(b)] = uint8_t(t);
+        }
+
     stm = WHITE;
+    cr = WOO | WOOO | BOO | BOOO;
+    ep = SQ_NONE;
+    rule50 = 0;
+    pliesFromNull = 0;
+    key = Zobrist::hash(*this);
+    pawnKey = Zobrist::pawn_hash(*this);
+    compute_psq();
+}
+
+void Position::compute_psq()
+{
+    psq = phase = 0;
+    for (int c = 0; c < 2; ++c)
+        for (int t = 0; t < 6; ++t) {
+            Bitboard b = bb[c][t];
+            while (b) {
+                psq += PSQT::psq(Side(c), PieceType(t), pop_lsb(b));
+                phase += PSQT::PHASE_INC[t];
+            }
+        }
+}
+
+/* ------------------------------------------------------------
+ *  print_board — доска в stdout (UCI "d", отладка perft)
+ *  белые заглавными, пустые поля — точки
+ * ------------------------------------------------------------*/
+void print_board(const Position& p) {
+    static const char sym[6] = { 'p','n','b','r','q','k' };
+    for (int r = 7; r >= 0; --r) {
+        for (int f = 0; f < 8; ++f) {
+            Square s = Square(f + 8 * r);
+            char c = '.';
+            PieceType pt = p.piece_on(s);
+            if (pt != NO_PIECE) {
+                c = sym[pt];
+                if (p.occ[WHITE] & one(s)) c = char(::toupper(c));
+            }
+            std::cout << c;
+        }
+        std::cout << '\n';
+    }
+    std::cout << std::flush;
 }
@@ -4,25 +4,57 @@
 #include "move.h"  
 #include <string>
 
+/* --- то, что ход меняет безвозвратно: do_move сохраняет сюда,
+   undo_move восстанавливает. Стек StateInfo по ply — свой у каждого потока --- */
+struct StateInfo {
+    uint64_t  key;
+    uint64_t  pawnKey;
+    Score     psq;
+    int       phase;
+    int       cr;
+    Square    ep;
+    int       rule50;
+    int       pliesFromNull;
+    PieceType captured;                // NO_PIECE — ход без взятия
+};
+
 struct Position {
-    //        : bb[WHITE/BLACK][PAWNKING]
+    // битборды для каждой стороны и каждого типа фигуры: bb[WHITE/BLACK][PAWN…KING]
     std::array<std::array<Bitboard, 6>, 2> bb{}; // bb[side][piece]
-    Bitboard occ[2]{};            //       
-    Bitboard occ_all{};           //     
-    Side stm = WHITE;             // ,  : WHITE  BLACK
+    Bitboard occ[2]{};            // дополнительно хранится битборд всех фигур конкретной стороны
+    Bitboard occ_all{};           // и общий битборд занятых клеток
+    std::array<uint8_t, 64> board{}; // mailbox: тип фигуры на поле (NO_PIECE = пусто), цвет — по occ
+    Side stm = WHITE;             // сторона, что ходит: WHITE или BLACK
 
     int cr = WOO | WOOO | BOO | BOOO;  // castling rights
     Square ep = SQ_NONE;               // en-passant square
+    uint64_t key = 0;                  // Zobrist-ключ, ведётся инкрементально в make_move
+    uint64_t pawnKey = 0;              // Zobrist только по пешкам — ключ пешечного кэша
+    Score psq = 0;                     // материал + PST (mg, eg) с точки зрения белых (PSQT::PSQ), тоже инкрементально
+    int phase = 0;                     // стадия игры 0..PSQT::PHASE_MAX по фигурам на доске
+    int rule50 = 0;                    // полуходы с последнего взятия / хода пешкой (правило 50 ходов)
+    int pliesFromNull = 0;             // полуходы с последнего нулевого хода: через него повторы не ищем
 
-    /* -------------  ------------- */
+    /* ------------- методы ------------- */
+    PieceType piece_on(Square s) const { return PieceType(board[s]); }
     void set_startpos();
-    bool attacked(Square sq, Side by) const; // ,    sq   by
-    void make_move(Move m, Position& nxt) const; //   +  
-    //     nxt,   m:
-    //  bb, occ, occ_all,
-    //  stm,
-    //    ep,
-    //     cr.
+    void compute_psq();                 // psq и phase с нуля — после FEN / startpos
+    bool attacked(Square sq, Side by) const; // Проверяет, атакуется ли квадрат sq фигурой стороны by
+    Bitboard attackers_to(Square sq, Bitboard occ) const; // все фигуры (обоих цветов), бьющие sq при занятости occ
+    bool see_ge(Move m, int threshold) const; // размен на to_sq(m) (SEE, с рентгеном) даёт >= threshold?
+    void make_move(Move m, Position& nxt) const; // copy-make: копия в nxt + do_move на ней
+    void do_move(Move m, StateInfo& st);         // ход на месте, старое состояние — в st
+    void undo_move(Move m, const StateInfo& st); // обратно, st — от того же do_move
+    void do_null_move(StateInfo& st);            // передать ход (null-move pruning)
+    void undo_null_move(const StateInfo& st);
+    // do_move применяет ход m:
+    // обновляет bb, occ, occ_all, board,
+    // меняет stm,
+    // сбрасывает или устанавливает ep, ведёт rule50 и pliesFromNull,
+    // обновляет права рокировки в cr,
+    // XOR-ит в key фигуры, рокировку, ep и сторону (пешки — ещё и в pawnKey),
+    // правит psq и phase по снятым/поставленным фигурам.
 };
 
-bool position_from_fen(Position& p, const std::string& fen);
\ No newline at end of file
+bool position_from_fen(Position& p, const std::string& fen);
+void print_board(const Position& p);           // доска в stdout: UCI "d", отладка perft
\ No newline at end of file
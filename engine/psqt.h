@@ -0,0 +1,196 @@
+﻿#pragma once
+#include "types.h"
+#include <array>
+
+/*---------------------------------------------
+ *  Материал  +  Piece-Square Tables (PST)
+ *  две стадии: миттельшпиль (MG) и эндшпиль (EG),
+ *  возвращается в сотых пешки
+ *--------------------------------------------*/
+
+constexpr int VAL[6] = { 100, 320, 330, 500, 900, 0 };
+constexpr int VAL_EG[6] = { 130, 300, 320, 520, 940, 0 };
+
+/*  таблицы записаны «как на диаграмме»: верхняя строка — 8-я горизонталь,
+    нижняя — 1-я, за белых (a8 … h8  …  a1 … h1)                       */
+constexpr int PST_PAWN[64] = {
+      0,  0,  0,  0,  0,  0,  0,  0,
+     50, 60, 70, 80, 80, 70, 60, 50,
+     30, 40, 50, 70, 70, 50, 40, 30,
+     20, 25, 30, 60, 60, 30, 25, 20,
+     10, 15, 20, 50, 50, 20, 15, 10,
+      5,  5, 15, 35, 35, 15,  5,  5,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0
+};
+
+constexpr int PST_KNIGHT[64] = {
+    -50,-40,-30,-30,-30,-30,-40,-50,
+    -40,-20,  0,  5,  5,  0,-20,-40,
+    -30,  5, 10, 15, 15, 10,  5,-30,
+    -30,  0, 15, 20, 20, 15,  0,-30,
+    -30,  5, 15, 20, 20, 15,  5,-30,
+    -30,  0, 10, 15, 15, 10,  0,-30,
+    -40,-20,  0,  0,  0,  0,-20,-40,
+    -50,-40,-30,-30,-30,-30,-40,-50
+};
+
+constexpr int PST_BISHOP[64] = {
+    -20,-10,-10,-10,-10,-10,-10,-20,
+    -10,  5,  0,  0,  0,  0,  5,-10,
+    -10, 10, 10, 10, 10, 10, 10,-10,
+    -10,  0, 10, 15, 15, 10,  0,-10,
+    -10,  5, 10, 15, 15, 10,  5,-10,
+    -10, 10, 10, 10, 10, 10, 10,-10,
+    -10,  5,  0,  0,  0,  0,  5,-10,
+    -20,-10,-10,-10,-10,-10,-10,-20
+};
+
+constexpr int PST_ROOK[64] = {
+      0,  0,  5, 10, 10,  5,  0,  0,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+     -5,  0,  0,  0,  0,  0,  0, -5,
+      5, 10, 10, 10, 10, 10, 10,  5,
+      0,  0,  5, 10, 10,  5,  0,  0
+};
+
+constexpr int PST_QUEEN[64] = {
+    -20,-10,-10, -5, -5,-10,-10,-20,
+    -10,  0,  5,  0,  0,  0,  0,-10,
+    -10,  5,  5,  5,  5,  5,  0,-10,
+     -5,  0,  5,  5,  5,  5,  0, -5,
+      0,  0,  5,  5,  5,  5,  0, -5,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+    -10,  0,  0,  0,  0,  0,  0,-10,
+    -20,-10,-10, -5, -5,-10,-10,-20
+};
+
+constexpr int PST_KING_MID[64] = {
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -30,-40,-40,-50,-50,-40,-40,-30,
+    -20,-30,-30,-40,-40,-30,-30,-20,
+    -10,-20,-20,-20,-20,-20,-20,-10,
+     20, 20,  0,  0,  0,  0, 20, 20,
+     20, 30, 10,  0,  0, 10, 30, 20
+};
+
+/* ------------------- эндшпиль ------------------- */
+
+constexpr int PST_PAWN_EG[64] = {
+      0,  0,  0,  0,  0,  0,  0,  0,
+     90, 90, 85, 80, 80, 85, 90, 90,
+     55, 55, 50, 45, 45, 50, 55, 55,
+     30, 30, 25, 20, 20, 25, 30, 30,
+     15, 15, 10, 10, 10, 10, 15, 15,
+      5,  5,  5,  0,  0,  5,  5,  5,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0
+};
+
+constexpr int PST_KNIGHT_EG[64] = {
+    -50,-40,-30,-30,-30,-30,-40,-50,
+    -40,-20,-10, -5, -5,-10,-20,-40,
+    -30,-10,  5, 10, 10,  5,-10,-30,
+    -30, -5, 10, 15, 15, 10, -5,-30,
+    -30, -5, 10, 15, 15, 10, -5,-30,
+    -30,-10,  5, 10, 10,  5,-10,-30,
+    -40,-20,-10, -5, -5,-10,-20,-40,
+    -50,-40,-30,-30,-30,-30,-40,-50
+};
+
+constexpr int PST_BISHOP_EG[64] = {
+    -15,-10,-10,-10,-10,-10,-10,-15,
+    -10,  0,  0,  0,  0,  0,  0,-10,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+    -10,  0,  5, 10, 10,  5,  0,-10,
+    -10,  0,  5, 10, 10,  5,  0,-10,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+    -10,  0,  0,  0,  0,  0,  0,-10,
+    -15,-10,-10,-10,-10,-10,-10,-15
+};
+
+constexpr int PST_ROOK_EG[64] = {
+     10, 10, 10, 10, 10, 10, 10, 10,
+     15, 15, 15, 15, 15, 15, 15, 15,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0,
+      0,  0,  0,  0,  0,  0,  0,  0
+};
+
+constexpr int PST_QUEEN_EG[64] = {
+    -20,-10,-10, -5, -5,-10,-10,-20,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+    -10,  5, 10, 10, 10, 10,  5,-10,
+     -5,  5, 10, 15, 15, 10,  5, -5,
+     -5,  5, 10, 15, 15, 10,  5, -5,
+    -10,  5, 10, 10, 10, 10,  5,-10,
+    -10,  0,  5,  5,  5,  5,  0,-10,
+    -20,-10,-10, -5, -5,-10,-10,-20
+};
+
+constexpr int PST_KING_EG[64] = {      // в эндшпиле король идёт в центр
+    -50,-40,-30,-20,-20,-30,-40,-50,
+    -30,-20,-10,  0,  0,-10,-20,-30,
+    -30,-10, 20, 30, 30, 20,-10,-30,
+    -30,-10, 30, 40, 40, 30,-10,-30,
+    -30,-10, 30, 40, 40, 30,-10,-30,
+    -30,-10, 20, 30, 30, 20,-10,-30,
+    -30,-30,  0,  0,  0,  0,-30,-30,
+    -50,-30,-30,-30,-30,-30,-30,-50
+};
+
+constexpr const int* PST[6] = { // Массив указателей на ПСТ таблицы 
+    PST_PAWN, PST_KNIGHT, PST_BISHOP, PST_ROOK, PST_QUEEN, PST_KING_MID
+};
+
+constexpr const int* PST_EG[6] = {
+    PST_PAWN_EG, PST_KNIGHT_EG, PST_BISHOP_EG, PST_ROOK_EG, PST_QUEEN_EG, PST_KING_EG
+};
+
+constexpr int mirror(int sq) { // Функция зеркалит квадрат по вертикали
+    return sq ^ 56; // a1 (0) → a8 (56)
+}
+
+/* --- материал + PST одной таблицей: PSQ[сторона][фигура][поле],
+   сразу со знаком с точки зрения белых. Position::psq — сумма по доске,
+   make_move правит её только по сдвинутым/снятым фигурам --- */
+namespace PSQT {
+
+    using Table = std::array<std::array<std::array<Score, 64>, 6>, 2>;
+
+    constexpr Table make_table() {
+        Table t{};
+        for (int pt = 0; pt < 6; ++pt)
+            for (int sq = 0; sq < 64; ++sq) {
+                /* таблицы «как на диаграмме»: для белых поле отражаем */
+                int w = mirror(sq), b = sq;
+                t[WHITE][pt][sq] = make_score(VAL[pt] + PST[pt][w], VAL_EG[pt] + PST_EG[pt][w]);
+                t[BLACK][pt][sq] = -make_score(VAL[pt] + PST[pt][b], VAL_EG[pt] + PST_EG[pt][b]);
+            }
+        return t;
+    }
+
+    inline constexpr Table PSQ = make_table();
+
+    /* стадия игры: 24 — все фигуры на доске, 0 — голые короли с пешками;
+       после превращений может выйти за 24, оценка её обрезает */
+    constexpr int PHASE_INC[6] = { 0, 1, 1, 2, 4, 0 };
+    constexpr int PHASE_MAX = 24;
+
+    inline Score psq(Side c, PieceType pt, Square sq) { return PSQ[c][pt][sq]; }
+
+    /* смешивание стадий: phase = PHASE_MAX — чистый mg, 0 — чистый eg */
+    inline int taper(Score s, int phase) {
+        int ph = phase < PHASE_MAX ? phase : PHASE_MAX;
+        return (mg_value(s) * ph + eg_value(s) * (PHASE_MAX - ph)) / PHASE_MAX;
+    }
+
+} // namespace
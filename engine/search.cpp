@@ -3,15 +3,24 @@
 
 #include "bitboard.h"
 #include "eval.h"
+#include "evalcache.h"
 #include "movegen.h"
 #include "order.h"
 #include "tt.h"
 #include "zobrist.h"
+#ifdef USE_NNUE
+#include "nnue/accumulator.h"
+#endif
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 /* ----------------------------
@@ -26,11 +35,40 @@ namespace {
     constexpr int  LMR_MIN_DEPTH = 3;
     constexpr int  MAX_PLY = 64;
     constexpr int  KILLER_SLOTS = 2;
+    constexpr int  SEE_PRUNE_DEPTH = 3;        // на малой глубине режем плохие взятия
+    constexpr int  SEE_PRUNE_MARGIN = 100;     // порог SEE: -100 * depth
     constexpr uint64_t LOG_INTERVAL = 1'000'000ULL;
-
-    static Move killer[MAX_PLY][KILLER_SLOTS]{};
-    static int  hist[64][64]{};
-    static uint64_t g_nodes = 0;                // общий счётчик
+    constexpr uint64_t TIME_CHECK_NODES = 1024;  // как часто главный поток смотрит на часы (степень 2)
+
+    /* --- состояние одного потока Lazy SMP ---
+       у каждого потока свои киллеры, история и счётчик узлов,
+       общая между потоками только TT */
+    struct Worker {
+        int      id = 0;                         // 0 = главный поток
+        Move     killer[MAX_PLY][KILLER_SLOTS]{};
+        int      hist[64][64]{};
+        uint64_t nodes = 0;
+        uint64_t qnodes = 0;                     // из них в квисенсии
+        uint64_t evalHits = 0, evalMisses = 0;   // EvalCache
+        Move     rootBest = 0;                   // лучший ход последней итерации на корне
+        SearchResult res{ 0, 0, 0, 0, 0, 0, 0 };
+        Pawns::Table pawns;                      // пешечный кэш потока
+        StateInfo st[MAX_PLY + 1];               // для undo_move: st[ply] — ход из узла ply
+        std::vector<uint64_t> keys;              // ключи: партия до корня, затем путь поиска
+        int      rootIdx = 0;                    // keys[rootIdx + ply] — позиция на ply
+#ifdef USE_NNUE
+        NNUE::AccumulatorStack acc;              // аккумуляторы по ply, свои у каждого потока
+#endif
+    };
+#ifdef USE_NNUE
+    static_assert(MAX_PLY < NNUE::STACK_SIZE, "NNUE stack must cover MAX_PLY");
+#endif
+
+    std::atomic<bool> g_stop{ false };           // главный поток доиграл / stop / время вышло
+    std::atomic<bool> g_ponder{ false };         // go ponder до ponderhit: часы не идут
+
+    std::thread searchThread;                    // асинхронный go
+    std::mutex  searchMutex;                     // start/wait из UCI-потока
 
     /* --- утилиты --- */
     inline bool is_capture(const Position& pos, Move m) {
@@ -40,11 +78,78 @@ namespace {
         Square ksq = Square(lsb_index(pos.bb[pos.stm][KING]));
         return pos.attacked(ksq, Side(pos.stm ^ 1));
     }
-    inline void store_killer(int ply, Move m) {
-        if (killer[ply][0] != m) {
-            killer[ply][1] = killer[ply][0];
-            killer[ply][0] = m;
+    /* статическая оценка: сначала EvalCache, с NNUE — через инкрементальный
+       стек потока (пропущенный на попадании ply стек досчитает позже сам) */
+    inline int static_eval(Worker& w, const Position& pos, int ply) {
+        int v;
+        if (EvalCache::probe(pos.key, v)) {
+            ++w.evalHits;
+            return v;
         }
+        ++w.evalMisses;
+#ifdef USE_NNUE
+        if (NNUE::loaded())
+            v = w.acc.evaluate(ply, pos);
+        else
+#endif
+            v = evaluate(pos, w.pawns);
+        (void)ply;
+        EvalCache::store(pos.key, v);
+        return v;
+    }
+    /* ход на месте + запись изменений признаков для следующего ply
+       (NNUE смотрит на позицию до хода — поэтому сначала аккумулятор) */
+    inline void do_move(Worker& w, Position& pos, Move m, int ply) {
+#ifdef USE_NNUE
+        if (NNUE::loaded())
+            w.acc.make_move(ply, pos, m);
+#endif
+        pos.do_move(m, w.st[ply]);
+        w.keys[w.rootIdx + ply + 1] = pos.key;
+    }
+    inline void undo_move(Worker& w, Position& pos, Move m, int ply) {
+        pos.undo_move(m, w.st[ply]);
+    }
+    /* повтор: та же позиция при том же ходе (через 4, 6, ... полуходов),
+       назад — только до последнего необратимого хода (rule50) и не дальше
+       нулевого (pliesFromNull) */
+    inline bool is_repetition(const Worker& w, const Position& pos, int ply) {
+        const uint64_t* k = w.keys.data() + w.rootIdx + ply;
+        const int n = std::min({ pos.rule50, pos.pliesFromNull, w.rootIdx + ply });
+        for (int i = 4; i <= n; i += 2)
+            if (k[-i] == pos.key)
+                return true;
+        return false;
+    }
+    /* ничья по 50 ходам, если только последний ход не поставил мат */
+    inline bool is_fifty_draw(const Position& pos) {
+        if (pos.rule50 < 100) return false;
+        if (!is_check(pos)) return true;
+        MoveList list;
+        generate_moves(pos, list);
+        return !list.empty();
+    }
+    inline void store_killer(Worker& w, int ply, Move m) {
+        if (w.killer[ply][0] != m) {
+            w.killer[ply][1] = w.killer[ply][0];
+            w.killer[ply][0] = m;
+        }
+    }
+    /* время проверяет только главный поток, раз в TIME_CHECK_NODES узлов;
+       пока не досчитана первая итерация, не прерываемся — иначе нечем ходить */
+    inline void check_time(const Worker& w) {
+        if (!TimeMan::enabled() || g_ponder.load(std::memory_order_relaxed) || w.res.depth == 0)
+            return;
+        if (TimeMan::elapsed() >= TimeMan::maximum())
+            g_stop = true;
+    }
+    inline void count_node(Worker& w) {
+        ++w.nodes;
+        if (w.id != 0) return;
+        if ((w.nodes & (TIME_CHECK_NODES - 1)) == 0)
+            check_time(w);
+        if ((w.nodes % LOG_INTERVAL) == 0)
+            std::cerr << "Progress: nodes=" << w.nodes << "\r";
     }
 
 } // namespace
@@ -53,34 +158,25 @@ namespace {
 /* ------------------------------
    КВИСЕНСИЯ
    ------------------------------*/
-static int quiescence(Position& pos, int alpha, int beta)
+static int quiescence(Worker& w, Position& pos, int alpha, int beta, int ply)
 {
-    int stand = evaluate(pos);
+    int stand = static_eval(w, pos, ply);
+    if (ply >= MAX_PLY - 1) return stand;
     if (stand >= beta) return beta;
     if (stand > alpha) alpha = stand;
 
-    std::vector<Move> moves;
-    generate_moves(pos, moves);                 // мы отфильтруем ниже
-
-    moves.erase(std::remove_if(moves.begin(), moves.end(),
-        [&](Move m) {
-            bool tact = is_capture(pos, m) || promo_of(m);
-            return !tact;
-        }), moves.end());
-
-    std::stable_sort(moves.begin(), moves.end(),
-        [&](Move a, Move b) { return move_score(pos, a) > move_score(pos, b); });
-
-    for (Move m : moves)
+    /* только взятия и превращения, по MVV/LVA; проигрывающие по SEE пропущены */
+    MovePicker mp(pos);
+    Move m;
+    while ((m = mp.next()))
     {
-        Position nxt;
-        pos.make_move(m, nxt);
+        do_move(w, pos, m, ply);
 
-        ++g_nodes;
-        if ((g_nodes % LOG_INTERVAL) == 0)
-            std::cerr << "Progress: nodes=" << g_nodes << "\r";
+        count_node(w);
+        ++w.qnodes;
 
-        int score = -quiescence(nxt, -beta, -alpha);
+        int score = -quiescence(w, pos, -beta, -alpha, ply + 1);
+        undo_move(w, pos, m, ply);
         if (score >= beta)  return beta;
         if (score > alpha)  alpha = score;
     }
@@ -90,109 +186,116 @@ static int quiescence(Position& pos, int alpha, int beta)
 /* -----------------------------
    PVS / alphabeta с TT, Null-Move, LMR
    -----------------------------*/
-static int alphabeta(Position& pos, int depth, int alpha, int beta, int ply)
+static int alphabeta(Worker& w, Position& pos, int depth, int alpha, int beta, int ply)
 {
+    /* помощник больше не нужен — результат всё равно выбросим */
+    if (g_stop.load(std::memory_order_relaxed))
+        return 0;
+
+    /* ничья повтором или по 50 ходам (на корне всё равно нужен ход) */
+    if (ply > 0 && (is_repetition(w, pos, ply) || is_fifty_draw(pos)))
+        return 0;
+
+    if (ply >= MAX_PLY - 1)
+        return static_eval(w, pos, ply);
+
     /* 0. mate distance pruning */
     alpha = std::max(alpha, -MATE_SCORE + ply);
     beta = std::min(beta, MATE_SCORE - ply - 1);
     if (alpha >= beta) return alpha;
-
-    /* 1. TT */
-    uint64_t key = Zobrist::hash(pos);
-    TT::Entry& tt = TT::probe(key);
-    if (tt.key == key && tt.depth >= depth) {
-        if (tt.flag == TT::EXACT)                              return tt.score;
-        if (tt.flag == TT::LOWER && tt.score >= beta)          return tt.score;
-        if (tt.flag == TT::UPPER && tt.score <= alpha)         return tt.score;
+    const int alphaOrig = alpha;                   // для флага TT: подняли alpha или нет
+
+    /* 1. TT (на корне не отсекаемся — нужен лучший ход) */
+    uint64_t key = pos.key;
+    bool ttHit;
+    TT::Entry* tt = TT::probe(key, ttHit);
+    if (ply > 0 && ttHit && tt->depth() >= depth) {
+        int ttScore = tt->score();
+        if (tt->flag() == TT::EXACT)                           return ttScore;
+        if (tt->flag() == TT::LOWER && ttScore >= beta)        return ttScore;
+        if (tt->flag() == TT::UPPER && ttScore <= alpha)       return ttScore;
     }
 
     /* 2. Лист квиссенсии */
     if (depth <= 0)
-        return quiescence(pos, alpha, beta);
+        return quiescence(w, pos, alpha, beta, ply);
+
+    const bool inCheck = is_check(pos);
 
     /* 3. Null-move pruning */
-    if (!is_check(pos) && depth >= 3) {
-        Position nullPos = pos;
-        nullPos.stm = Side(1 - pos.stm);
-        nullPos.ep = SQ_NONE;
+    if (ply > 0 && !inCheck && depth >= 3) {
+#ifdef USE_NNUE
+        if (NNUE::loaded())
+            w.acc.make_null(ply);
+#endif
+        pos.do_null_move(w.st[ply]);
+        w.keys[w.rootIdx + ply + 1] = pos.key;
 
         int R = NULL_REDUCTION_BASE + (depth > 6);
-        int score = -alphabeta(nullPos, depth - 1 - R, -beta, -beta + 1, ply + 1);
+        int score = -alphabeta(w, pos, depth - 1 - R, -beta, -beta + 1, ply + 1);
+        pos.undo_null_move(w.st[ply]);
+        if (g_stop.load(std::memory_order_relaxed))
+            return 0;
         if (score >= beta)
             return beta;
     }
 
-    
 
-    /* 4. Генерация и сортировка */
-    std::vector<Move> moves;
-    generate_moves(pos, moves);
-    if (moves.empty()) {                                   // мат или пат
-        return is_check(pos) ? -MATE_SCORE + ply : 0;
-    }
-
-    Move ttMove = (tt.key == key) ? tt.best : 0;
-    std::stable_sort(moves.begin(), moves.end(),
-        [&](Move a, Move b)
-        {
-            if (a == ttMove) return true;
-            if (b == ttMove) return false;
-
-            int sa = move_score(pos, a);
-            int sb = move_score(pos, b);
 
-            if (a == killer[ply][0]) sa += 1'000'000;
-            else if (a == killer[ply][1]) sa += 500'000;
-
-            if (b == killer[ply][0]) sb += 1'000'000;
-            else if (b == killer[ply][1]) sb += 500'000;
-
-            sa += hist[from_sq(a)][to_sq(a)];
-            sb += hist[from_sq(b)][to_sq(b)];
-
-            return sa > sb;
-        });
+    /* 4. Ходы по стадиям: TT -> взятия -> киллеры -> тихие */
+    Move ttMove = ttHit ? tt->move() : 0;
+    MovePicker mp(pos, ttMove, w.killer[ply], w.hist);
 
     /* 5. Перебор */
     Move  bestMove = 0;
     int   bestEval = -INF;
     int   moveNo = 0;
 
-    for (Move m : moves)
+    Move m;
+    while ((m = mp.next()))
     {
+        /* у самого горизонта явно проигрывающие взятия не смотрим */
+        if (depth <= SEE_PRUNE_DEPTH && bestMove && !inCheck && is_capture(pos, m)
+            && !pos.see_ge(m, -SEE_PRUNE_MARGIN * depth))
+            continue;
+
         ++moveNo;
 
-        Position nxt;
-        pos.make_move(m, nxt);
+        bool capture = is_capture(pos, m);                  // пока позиция ещё до хода
+        do_move(w, pos, m, ply);
 
-        ++g_nodes;
-        if ((g_nodes % LOG_INTERVAL) == 0)
-            std::cerr << "Progress: nodes=" << g_nodes << "\r";
+        count_node(w);
 
         /* LMR для нетактических и непривилегированных ходов */
         int newDepth = depth - 1;
-        bool tactical = is_capture(pos, m) || promo_of(m) || is_check(nxt);
+        bool tactical = capture || promo_of(m) || is_check(pos);
         if (!tactical && depth >= LMR_MIN_DEPTH && moveNo > 3)
             newDepth -= 1;
 
         int score;
         if (bestMove == 0) {                                // полный окно
-            score = -alphabeta(nxt, newDepth, -beta, -alpha, ply + 1);
+            score = -alphabeta(w, pos, newDepth, -beta, -alpha, ply + 1);
         }
         else {
             // пробный узкий поиск (PVS)
-            score = -alphabeta(nxt, newDepth, -alpha - 1, -alpha, ply + 1);
+            score = -alphabeta(w, pos, newDepth, -alpha - 1, -alpha, ply + 1);
             if (score > alpha && score < beta)              // не угадали – ресёрч
-                score = -alphabeta(nxt, newDepth, -beta, -alpha, ply + 1);
+                score = -alphabeta(w, pos, newDepth, -beta, -alpha, ply + 1);
         }
+        undo_move(w, pos, m, ply);
+
+        /* прерванный поиск в TT не пишем */
+        if (g_stop.load(std::memory_order_relaxed))
+            return 0;
 
         if (score >= beta) {
             /* бета-отсечение */
             if (!tactical) {
-                store_killer(ply, m);
-                hist[from_sq(m)][to_sq(m)] += depth * depth;
+                store_killer(w, ply, m);
+                w.hist[from_sq(m)][to_sq(m)] += depth * depth;
             }
-            tt = { key, int8_t(depth), int16_t(beta), TT::LOWER, m };
+            if (ply == 0) w.rootBest = m;
+            tt->save(key, depth, beta, TT::LOWER, m);
             return beta;
         }
 
@@ -203,28 +306,37 @@ static int alphabeta(Position& pos, int depth, int alpha, int beta, int ply)
         }
     }
 
+    if (moveNo == 0)                                       // мат или пат
+        return inCheck ? -MATE_SCORE + ply : 0;
+
     /* 6. запись в TT */
-    tt = { key, int8_t(depth), int16_t(bestEval),
-           (bestMove ? TT::EXACT : TT::UPPER), bestMove };
+    if (ply == 0) w.rootBest = bestMove;
+    tt->save(key, depth, bestEval, bestEval > alphaOrig ? TT::EXACT : TT::UPPER, bestMove);
     return bestEval;
 }
 
 /* -----------------------------------
    Итеративное углубление + aspiration
+   главный поток идёт 1..maxDepth, помощники (Lazy SMP) крутят
+   те же итерации со сдвигом глубины, пока главный не закончит,
+   и делятся найденным только через TT
    ----------------------------------- */
-SearchResult search(Position& root, int maxDepth)
+static void iterate(Worker& w, Position root, int maxDepth)
 {
-    SearchResult res{ 0, 0, 0 };
-
-    std::fill(&killer[0][0], &killer[0][0] + MAX_PLY * KILLER_SLOTS, 0);
-    std::fill(&hist[0][0], &hist[0][0] + 64 * 64, 0);
+    SearchResult& res = w.res;
 
     int alpha = -INF;
     int beta = INF;
 
+#ifdef USE_NNUE
+    if (NNUE::loaded())
+        w.acc.reset(root);                       // запись 0 — корень, дальше только инкременты
+#endif
+
     for (int depth = 1; depth <= maxDepth; ++depth)
     {
-        g_nodes = 0;
+        /* нечётные помощники считают на 1 глубже — меньше дублируют главный */
+        int d = (w.id != 0 && (w.id & 1)) ? std::min(depth + 1, MAX_PLY - 1) : depth;
 
         /* aspiration-окно вокруг прошлого статического */
         if (depth >= 3) {
@@ -238,7 +350,9 @@ SearchResult search(Position& root, int maxDepth)
 
         while (true)
         {
-            int val = alphabeta(root, depth, alpha, beta, 0);
+            int val = alphabeta(w, root, d, alpha, beta, 0);
+            if (g_stop.load(std::memory_order_relaxed))
+                return;
             if (val <= alpha) {           // fail-low
                 alpha -= ASP_WIN;
                 continue;
@@ -252,11 +366,119 @@ SearchResult search(Position& root, int maxDepth)
             break;
         }
 
-        /* лучший ход храним из TT верхнего уровня */                             // 17.05 #TODO tt.h
-        TT::Entry& rootTT = TT::probe(Zobrist::hash(root));
-        res.best = rootTT.best;
-        res.nodes += g_nodes;
+        res.best = w.rootBest;
+        res.depth = d;
+
+        /* следующая итерация дороже всех предыдущих — за optimum не начинаем */
+        if (w.id == 0 && TimeMan::enabled() && !g_ponder.load(std::memory_order_relaxed)
+            && TimeMan::elapsed() >= TimeMan::optimum())
+            break;
     }
+}
 
+/* -----------------------------------
+   Один go целиком: g_stop и часы выставляет вызывающий
+   ----------------------------------- */
+static SearchResult run_search(Position root, const std::vector<uint64_t>& history,
+                               const SearchLimits& limits, int threads)
+{
+    int maxDepth = limits.depth > 0 ? std::min(limits.depth, MAX_PLY - 2) : MAX_PLY - 2;
+    threads = std::max(threads, 1);
+    TT::new_search();
+
+    /* Worker большой (история 16 КБ) — держим в куче, не на стеке;
+       стек ключей у каждого свой: история партии, корень, MAX_PLY ходов поиска */
+    std::vector<std::unique_ptr<Worker>> workers;
+    for (int i = 0; i < threads; ++i) {
+        workers.push_back(std::make_unique<Worker>());
+        Worker& w = *workers.back();
+        w.id = i;
+        w.keys.assign(history.begin(), history.end());
+        w.keys.resize(history.size() + MAX_PLY + 1);
+        w.rootIdx = int(history.size());
+        w.keys[w.rootIdx] = root.key;
+    }
+
+    /* помощники: итерируют до упора, останавливает их главный поток */
+    std::vector<std::thread> helpers;
+    for (int i = 1; i < threads; ++i)
+        helpers.emplace_back(iterate, std::ref(*workers[i]), root, MAX_PLY - 2);
+
+    iterate(*workers[0], root, maxDepth);
+
+    /* go infinite / ponder: bestmove только после stop или ponderhit */
+    while (!g_stop.load() && (g_ponder.load() || limits.infinite))
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+    g_stop = true;
+    for (std::thread& t : helpers)
+        t.join();
+
+    SearchResult res = workers[0]->res;
+    res.nodes = res.qnodes = res.evalHits = res.evalMisses = 0;
+    for (auto& w : workers) {
+        res.nodes += w->nodes;
+        res.qnodes += w->qnodes;
+        res.evalHits += w->evalHits;
+        res.evalMisses += w->evalMisses;
+    }
+
+    /* stop пришёл раньше, чем досчитана первая итерация */
+    if (!res.best) {
+        MoveList list;
+        generate_moves(root, list);
+        if (!list.empty()) res.best = list[0];
+    }
     return res;
 }
+
+SearchResult search(Position& root, int maxDepth, int threads)
+{
+    SearchLimits lim;
+    lim.depth = maxDepth;
+    return search(root, lim, threads);
+}
+
+SearchResult search(Position& root, const SearchLimits& limits, int threads, int overhead)
+{
+    g_stop = false;
+    g_ponder = limits.ponder;
+    TimeMan::init(limits, root.stm, overhead);
+    return run_search(root, {}, limits, threads);
+}
+
+
+void start_search(const Position& root, const std::vector<uint64_t>& history, const SearchLimits& limits,
+                  int threads, int overhead, std::function<void(const SearchResult&)> done)
+{
+    wait_search();
+
+    std::lock_guard<std::mutex> lock(searchMutex);
+    /* флаги ставим до запуска потока: stop сразу за go не потеряется */
+    g_stop = false;
+    g_ponder = limits.ponder;
+    TimeMan::init(limits, root.stm, overhead);
+
+    searchThread = std::thread([=]() {
+        done(run_search(root, history, limits, threads));
+    });
+}
+
+void stop_search()
+{
+    g_ponder = false;
+    g_stop = true;
+}
+
+void ponderhit()
+{
+    TimeMan::restart();                          // часы GUI пошли только сейчас
+    g_ponder = false;
+}
+
+void wait_search()
+{
+    std::lock_guard<std::mutex> lock(searchMutex);
+    if (searchThread.joinable())
+        searchThread.join();
+}
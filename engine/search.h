@@ -1,13 +1,31 @@
 #pragma once
 #include "movegen.h"
 #include "eval.h"
+#include "timeman.h"
 #include <cstdint>
+#include <functional>
 #include <vector>
 
 struct SearchResult {
     Move best;
-    int  score;          //   
+    int  score;          // в сотых пешки
     uint64_t nodes;
+    uint64_t qnodes;     // из них в квисенсии
+    int  depth;          // последняя полностью досчитанная итерация
+    uint64_t evalHits;   // статическая оценка взята из EvalCache
+    uint64_t evalMisses; // посчитана заново
 };
 
-SearchResult search(Position& root, int depth);
\ No newline at end of file
+// threads > 1 — Lazy SMP: помощники делят с главным потоком только TT
+SearchResult search(Position& root, int depth, int threads = 1);
+SearchResult search(Position& root, const SearchLimits& limits, int threads = 1, int overhead = TimeMan::DEFAULT_OVERHEAD);
+
+/* --- асинхронный go: поиск в своём потоке, UCI-цикл остаётся отзывчивым ---
+   done вызывается из потока поиска, когда пора печатать bestmove
+   (при infinite/ponder — не раньше stop или ponderhit);
+   history — ключи позиций партии до root, старые первыми (для повторений) */
+void start_search(const Position& root, const std::vector<uint64_t>& history, const SearchLimits& limits,
+                  int threads, int overhead, std::function<void(const SearchResult&)> done);
+void stop_search();                      // stop: прерываем, отдаём последнюю полную итерацию
+void ponderhit();                        // соперник сыграл ожидаемый ход — включаем часы
+void wait_search();                      // дождаться завершения (перед position/quit и т.п.)
@@ -0,0 +1,78 @@
+﻿// engine/timeman.cpp
+#include "timeman.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+
+namespace {
+
+    constexpr int MTG_HORIZON = 40;        // при внезапной смерти считаем, что ходов осталось столько
+    constexpr int MAX_RATIO = 5;           // maximum не больше optimum * MAX_RATIO
+    constexpr int MAX_SHARE = 80;          // и не больше 80% остатка на часах
+
+    std::atomic<int64_t> startMs{ 0 };     // пишет UCI-поток (ponderhit), читает поиск
+    bool    active = false;
+    int64_t optimumMs = 0;
+    int64_t maximumMs = 0;
+
+    inline int64_t now_ms() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+} // namespace
+
+
+void TimeMan::init(const SearchLimits& lim, Side us, int overhead)
+{
+    startMs = now_ms();
+    active = false;
+    optimumMs = maximumMs = 0;
+
+    if (lim.infinite)
+        return;
+
+    if (lim.movetime > 0) {
+        optimumMs = maximumMs = std::max<int64_t>(1, lim.movetime - overhead);
+        active = true;
+        return;
+    }
+
+    if (lim.time[us] <= 0)                        // go depth N — часов нет
+        return;
+
+    int64_t left = std::max<int64_t>(1, lim.time[us] - overhead);
+    int mtg = lim.movestogo > 0 ? std::min(lim.movestogo, MTG_HORIZON) : MTG_HORIZON;
+
+    optimumMs = left / mtg + lim.inc[us] * 3 / 4;
+    maximumMs = std::min(optimumMs * MAX_RATIO, left * MAX_SHARE / 100);
+    maximumMs = std::max<int64_t>(maximumMs, 1);
+    optimumMs = std::clamp<int64_t>(optimumMs, 1, maximumMs);
+    active = true;
+}
+
+void TimeMan::restart()
+{
+    startMs = now_ms();
+}
+
+bool TimeMan::enabled()
+{
+    return active;
+}
+
+int64_t TimeMan::elapsed()
+{
+    return now_ms() - startMs.load(std::memory_order_relaxed);
+}
+
+int64_t TimeMan::optimum()
+{
+    return optimumMs;
+}
+
+int64_t TimeMan::maximum()
+{
+    return maximumMs;
+}
@@ -0,0 +1,29 @@
+﻿#pragma once
+#include "types.h"
+#include <cstdint>
+
+/* --- параметры команды go --- */
+struct SearchLimits {
+    int      depth = 0;                  // 0 = без ограничения глубины
+    int64_t  movetime = 0;               // мс на ход
+    int64_t  time[2]{};                  // wtime / btime, мс
+    int64_t  inc[2]{};                   // winc / binc, мс
+    int      movestogo = 0;              // 0 = внезапная смерть
+    bool     infinite = false;           // до команды stop
+    bool     ponder = false;             // думаем на чужом времени до ponderhit
+};
+
+namespace TimeMan {
+
+    constexpr int DEFAULT_OVERHEAD = 30;  // мс на задержки GUI/сети (Move Overhead)
+
+    /* считает оптимальное и максимальное время на ход и запускает часы */
+    void    init(const SearchLimits& lim, Side us, int overhead);
+    void    restart();                    // ponderhit: отсчёт заново с этого момента
+
+    bool    enabled();                    // false — go depth / infinite, часов нет
+    int64_t elapsed();                    // мс с начала поиска
+    int64_t optimum();                    // после итерации дольше этого — не начинаем новую
+    int64_t maximum();                    // жёсткая граница, прерываем посреди итерации
+
+} // namespace
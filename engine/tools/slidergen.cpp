@@ -0,0 +1,100 @@
+﻿// engine/tools/slidergen.cpp
+// Генератор таблиц атак ладей/слонов: запускается при сборке
+// (см. engine/CMakeLists.txt) и пишет slider_tables.inc, который
+// magic.cpp включает как готовые константы — в .rodata, без init.
+// Пишутся обе раскладки: [0] — под магию, [1] — под PEXT.
+#include "../magic.h"
+#include "../magic_data.h"
+
+#include <cstdio>
+#include <vector>
+
+using namespace MagicData;
+
+namespace {
+
+    struct Layout {
+        std::vector<Bitboard> table = std::vector<Bitboard>(SLIDER_TABLE_SIZE, 0);
+        uint32_t rookOffset[64]{}, bishopOffset[64]{};
+        size_t used = 0;
+    };
+
+    /* кусок одного поля: для PEXT индекс = номер подмножества маски,
+       для магии — (occ * magic) >> shift */
+    void fill(Layout& l, bool pext, Square sq, Bitboard mask, uint64_t magic, unsigned shift,
+              bool rook, uint32_t& offset)
+    {
+        int bits = popcount(mask);
+        offset = uint32_t(l.used);
+        l.used += size_t(1) << (pext ? bits : 64 - shift);
+        for (int idx = 0; idx < (1 << bits); ++idx) {
+            Bitboard occ = index_to_occ(idx, mask);
+            size_t key = pext ? size_t(idx) : size_t((occ * magic) >> shift);
+            l.table[offset + key] = rook ? rook_attack_on_the_fly(sq, occ)
+                                         : bishop_attack_on_the_fly(sq, occ);
+        }
+    }
+
+    void print_offsets(FILE* f, const char* name, const Layout (&l)[2], bool rook)
+    {
+        std::fprintf(f, "static constexpr uint32_t %s[2][64] = {\n", name);
+        for (const Layout& x : l) {
+            std::fprintf(f, "  {");
+            for (int i = 0; i < 64; ++i)
+                std::fprintf(f, "%s%u", i ? "," : "", rook ? x.rookOffset[i] : x.bishopOffset[i]);
+            std::fprintf(f, "},\n");
+        }
+        std::fprintf(f, "};\n");
+    }
+
+} // namespace
+
+int main(int argc, char* argv[])
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: slidergen <out.inc>\n");
+        return 1;
+    }
+
+    Bitboard rookMask[64], bishopMask[64];
+    for (int i = 0; i < 64; ++i) {
+        rookMask[i] = mask_rook(Square(i));
+        bishopMask[i] = mask_bishop(Square(i));
+    }
+
+    Layout l[2];
+    for (int p = 0; p < 2; ++p) {
+        for (int i = 0; i < 64; ++i)
+            fill(l[p], p == 1, Square(i), rookMask[i], RookMagic[i], RookShift[i], true, l[p].rookOffset[i]);
+        for (int i = 0; i < 64; ++i)
+            fill(l[p], p == 1, Square(i), bishopMask[i], BishopMagic[i], BishopShift[i], false, l[p].bishopOffset[i]);
+        if (l[p].used > size_t(SLIDER_TABLE_SIZE)) {
+            std::fprintf(stderr, "slidergen: table overflow, %zu entries\n", l[p].used);
+            return 1;
+        }
+    }
+
+    FILE* f = std::fopen(argv[1], "w");
+    if (!f) {
+        std::fprintf(stderr, "slidergen: cannot write %s\n", argv[1]);
+        return 1;
+    }
+    std::fprintf(f, "// slider_tables.inc: generated by tools/slidergen.cpp, do not edit\n");
+    std::fprintf(f, "static constexpr Bitboard RookMaskGen[64] = {");
+    for (int i = 0; i < 64; ++i) std::fprintf(f, "%s0x%llxULL", i ? "," : "", (unsigned long long)rookMask[i]);
+    std::fprintf(f, "};\nstatic constexpr Bitboard BishopMaskGen[64] = {");
+    for (int i = 0; i < 64; ++i) std::fprintf(f, "%s0x%llxULL", i ? "," : "", (unsigned long long)bishopMask[i]);
+    std::fprintf(f, "};\n");
+    print_offsets(f, "RookOffsetGen", l, true);
+    print_offsets(f, "BishopOffsetGen", l, false);
+
+    std::fprintf(f, "alignas(64) static constexpr Bitboard SliderTableGen[2][SLIDER_TABLE_SIZE] = {\n");
+    for (const Layout& x : l) {
+        std::fprintf(f, "{\n");
+        for (size_t i = 0; i < x.table.size(); ++i)
+            std::fprintf(f, "0x%llxULL,%s", (unsigned long long)x.table[i], (i & 7) == 7 ? "\n" : "");
+        std::fprintf(f, "},\n");
+    }
+    std::fprintf(f, "};\n");
+    return std::fclose(f) == 0 ? 0 : 1;
+}
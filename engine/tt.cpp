@@ -0,0 +1,183 @@
+// engine/tt.cpp
+#include "tt.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+#include <thread>
+#include <vector>
+
+#if defined(_WIN32)
+#define NOMINMAX
+#include <windows.h>
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace {
+
+    constexpr uint8_t GEN_DELTA = 4;             // младшие 2 бита заняты флагом
+    constexpr uint8_t GEN_MASK = 0xFC;
+    constexpr int     GEN_CYCLE = 255 + GEN_DELTA; // запас, чтобы флаг не занимал из поколения
+
+    TT::Bucket* table = nullptr;
+    size_t      bucketCount = 0;
+    uint8_t     generation8 = 0;
+
+    inline uint64_t mul_hi64(uint64_t a, uint64_t b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+        return __umulh(a, b);
+#elif defined(__SIZEOF_INT128__)
+        return uint64_t((unsigned __int128)a * b >> 64);
+#else
+        uint64_t aL = uint32_t(a), aH = a >> 32;
+        uint64_t bL = uint32_t(b), bH = b >> 32;
+        uint64_t c1 = (aL * bL) >> 32;
+        uint64_t c2 = aH * bL + c1;
+        uint64_t c3 = aL * bH + uint32_t(c2);
+        return aH * bH + (c2 >> 32) + (c3 >> 32);
+#endif
+    }
+
+    /* сколько поколений назад записана запись (0..63); флаг в младших битах
+       genFlag вычитается из GEN_CYCLE и до битов поколения не доходит */
+    inline int relative_age(const TT::Entry& e) {
+        return ((GEN_CYCLE + generation8 - e.genFlag) & GEN_MASK) / GEN_DELTA;
+    }
+
+    /* --------------------------------------------------------
+     *  Выделение памяти с учётом больших страниц
+     *  Linux  : выравнивание на 2 МБ + madvise(MADV_HUGEPAGE)
+     *  Windows: MEM_LARGE_PAGES (нужна привилегия SeLockMemory),
+     *           без неё — обычный VirtualAlloc
+     * --------------------------------------------------------*/
+    void* alloc_large(size_t size) {
+#if defined(_WIN32)
+        size_t large = GetLargePageMinimum();
+        if (large) {
+            size_t sz = (size + large - 1) / large * large;
+            void* p = VirtualAlloc(nullptr, sz, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+            if (p) return p;
+        }
+        return VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+#elif defined(__linux__)
+        constexpr size_t HUGE_PAGE = 2 * 1024 * 1024;
+        size_t sz = (size + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+        void* p = std::aligned_alloc(HUGE_PAGE, sz);
+        if (p) madvise(p, sz, MADV_HUGEPAGE);
+        return p;
+#else
+        return ::operator new(size, std::align_val_t(64), std::nothrow);
+#endif
+    }
+
+    void free_large(void* p) {
+        if (!p) return;
+#if defined(_WIN32)
+        VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__linux__)
+        std::free(p);
+#else
+        ::operator delete(p, std::align_val_t(64));
+#endif
+    }
+
+} // namespace
+
+
+void TT::Entry::save(uint64_t key, int depth, int score, Flag f, Move m)
+{
+    uint16_t k = uint16_t(key);
+
+    /* чужая позиция или новый ход — ход перезаписываем, иначе храним старый */
+    if (m || k != key16)
+        move16 = m;
+
+    /* глубокие записи не затираем мелкими, кроме точных и устаревших */
+    if (f == EXACT || k != key16 || depth + 2 > depth8 || relative_age(*this) != 0) {
+        key16 = k;
+        score16 = int16_t(score);
+        depth8 = int8_t(depth);
+        genFlag = uint8_t(generation8 | f);
+    }
+}
+
+TT::Entry* TT::probe(uint64_t key, bool& found)
+{
+    Entry* e = table[mul_hi64(key, bucketCount)].e;
+    uint16_t k = uint16_t(key);
+
+    for (int i = 0; i < BUCKET_SIZE; ++i)
+        if (e[i].key16 == k && e[i].flag() != NONE) {
+            e[i].genFlag = uint8_t(generation8 | e[i].flag());   // освежаем поколение
+            found = true;
+            return &e[i];
+        }
+
+    /* замена: минимальная глубина, старые поколения дешевле на 8 полуходов */
+    Entry* replace = &e[0];
+    for (int i = 0; i < BUCKET_SIZE; ++i) {
+        if (e[i].flag() == NONE) { replace = &e[i]; break; }
+        if (e[i].depth8 - 8 * relative_age(e[i]) < replace->depth8 - 8 * relative_age(*replace))
+            replace = &e[i];
+    }
+    found = false;
+    return replace;
+}
+
+void TT::resize(size_t mb)
+{
+    free_large(table);
+    table = nullptr;
+
+    mb = std::max<size_t>(mb, 1);
+    bucketCount = mb * 1024 * 1024 / sizeof(Bucket);
+    table = static_cast<Bucket*>(alloc_large(bucketCount * sizeof(Bucket)));
+    if (!table) {
+        std::fprintf(stderr, "info string failed to allocate %zu MB for TT\n", mb);
+        std::exit(EXIT_FAILURE);
+    }
+    clear();
+}
+
+void TT::clear(int threads)
+{
+    if (!table) {                                 // первый вызов до setoption
+        resize(DEFAULT_MB);
+        return;
+    }
+
+    threads = std::max(threads, 1);
+    size_t stride = bucketCount / threads;
+    std::vector<std::thread> pool;
+    for (int i = 0; i < threads; ++i)
+        pool.emplace_back([=]() {
+            size_t start = stride * i;
+            size_t len = (i == threads - 1) ? bucketCount - start : stride;
+            std::memset(static_cast<void*>(&table[start]), 0, len * sizeof(Bucket));
+        });
+    for (std::thread& t : pool)
+        t.join();
+
+    generation8 = 0;
+}
+
+void TT::new_search()
+{
+    generation8 += GEN_DELTA;
+}
+
+int TT::hashfull()
+{
+    int cnt = 0;
+    for (size_t i = 0; i < 1000 / BUCKET_SIZE && i < bucketCount; ++i)
+        for (const Entry& e : table[i].e)
+            cnt += e.flag() != NONE && (e.genFlag & GEN_MASK) == generation8;
+    return cnt * 1000 / (BUCKET_SIZE * int(1000 / BUCKET_SIZE));
+}
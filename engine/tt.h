@@ -1,22 +1,47 @@
-﻿#pragma once
+#pragma once
 #include "move.h"
+#include <cstddef>
 #include <cstdint>
 
-namespace TT {                                                  // РАЗОБРАТЬСЯ ТУТ ЧЕТА НЕ ТАК      #TODO
+namespace TT {
 
-    enum Flag : uint8_t { EXACT, LOWER, UPPER };
+    enum Flag : uint8_t { NONE, EXACT, LOWER, UPPER };   // NONE = пустой слот
 
+    /* --- одна запись: 8 байт ---
+       key16   — младшие 16 бит ключа (старшие ушли в индекс бакета)
+       genFlag — 6 бит поколения | 2 бита флага */
     struct Entry {
-        uint64_t key = 0;
-        int8_t   depth = 0;
-        int16_t  score = 0;
-        uint8_t  flag = EXACT;
-        Move     best = 0;
+        uint16_t key16 = 0;
+        Move     move16 = 0;                 // ход хранится как есть, 16 бит с типом
+        int16_t  score16 = 0;
+        int8_t   depth8 = 0;
+        uint8_t  genFlag = NONE;
+
+        Move  move()  const { return move16; }
+        int   score() const { return score16; }
+        int   depth() const { return depth8; }
+        Flag  flag()  const { return Flag(genFlag & 3); }
+
+        void save(uint64_t key, int depth, int score, Flag f, Move m);
     };
 
-    constexpr size_t SIZE = 1 << 20;              // 1 М слотов примерно 8 МБ
-    inline Entry table[SIZE];
+    /* --- бакет = одна кэш-линия, 8 записей --- */
+    constexpr int BUCKET_SIZE = 8;
+    struct alignas(64) Bucket {
+        Entry e[BUCKET_SIZE];
+    };
+    static_assert(sizeof(Entry) == 8, "TT::Entry must stay packed");
+    static_assert(sizeof(Bucket) == 64, "TT::Bucket must fill one cache line");
+
+    constexpr size_t DEFAULT_MB = 16;
+
+    void   resize(size_t mb);                    // setoption name Hash; таблица очищается
+    void   clear(int threads = 1);               // ucinewgame; чистим кусками в threads потоков
+    void   new_search();                         // +1 поколение перед каждым go
+    int    hashfull();                           // промилле занятых записей текущего поколения
 
-    inline Entry& probe(uint64_t key) { return table[key & (SIZE - 1)]; }
+    /* found = true — ключ совпал, иначе вернётся слот на замену
+       (пустой, либо самый мелкий/старый в бакете) */
+    Entry* probe(uint64_t key, bool& found);
 
-} // namespace
\ No newline at end of file
+} // namespace
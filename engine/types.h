@@ -1,10 +1,10 @@
 #pragma once
 #include <cstdint>
 
-using Bitboard = uint64_t; //   
+using Bitboard = uint64_t; // создаем битборд 
 
-/* =====  =====  (a1 = 0, b1 = 1, , h8 = 63) */
-enum Square : int { //    
+/* ===== Квадрат =====  (a1 = 0, b1 = 1, …, h8 = 63) */
+enum Square : int { // Слева направо снизу вверх
     A1, B1, C1, D1, E1, F1, G1, H1,
     A2, B2, C2, D2, E2, F2, G2, H2,
     A3, B3, C3, D3, E3, F3, G3, H3,
@@ -16,9 +16,24 @@ enum Square : int { // 
     SQ_NONE = 64
 };
 
-inline constexpr Bitboard one(Square s) { return 1ULL << s; } // ,  ,        s
+inline constexpr Bitboard one(Square s) { return 1ULL << s; } // утилита, возвращающая битборд, где установлен ровно один бит в позиции s
 
-/* =====  /  ===== */
+/* ===== Сторона / фигуры ===== */
 enum Side : int { WHITE = 0, BLACK = 1, NO_SIDE = 2 };
 enum PieceType : int { PAWN, KNIGHT, BISHOP, ROOK, QUEEN, KING, NO_PIECE };
-enum Castling : int { WOO = 1, WOOO = 2, BOO = 4, BOOO = 8 };
\ No newline at end of file
+enum Castling : int { WOO = 1, WOOO = 2, BOO = 4, BOOO = 8 };
+
+/* --- Score: пара (mg, eg) в одном int32 — eg в старших 16 битах,
+   mg в младших. Сложение/вычитание пар — одна целочисленная операция,
+   так что psq ведётся для обеих стадий по цене одной --- */
+using Score = int32_t;
+
+constexpr Score make_score(int mg, int eg) {
+    return Score(int32_t(uint32_t(eg) << 16) + mg);
+}
+constexpr int mg_value(Score s) {                 // младшая половина со знаком
+    return int16_t(uint16_t(uint32_t(s)));
+}
+constexpr int eg_value(Score s) {                 // +0x8000 — поправка на заём из mg
+    return int16_t(uint16_t(uint32_t(s + 0x8000) >> 16));
+}
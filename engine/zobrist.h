@@ -4,11 +4,46 @@
 
 namespace Zobrist {
 
-	inline uint64_t R[2][6][64];   // --
-	inline uint64_t CASTLE[16];    // 4-  
-	inline uint64_t EP[8];         //  en-passant (a-h)
-	inline uint64_t SIDE;          //  
+	/* фукнция генерации псевдорандомных 64 битных чисел Steele/Vigna */
+	constexpr uint64_t splitmix64(uint64_t& x)
+	{
+		x += 0x9e3779b97f4a7c15ULL;
+		uint64_t z = x;
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+		return z ^ (z >> 31);
+	}
 
-	void init();                         //  1   
-	uint64_t hash(const Position& pos);  //   
+	/* все ключи из одного фиксированного зерна — считаются при компиляции,
+	   порядок выдачи тот же, что был у init(): ключи не изменились */
+	struct Keys {
+		uint64_t R[2][6][64]{};
+		uint64_t CASTLE[16]{};
+		uint64_t EP[8]{};
+		uint64_t SIDE = 0;
+	};
+
+	constexpr Keys make_keys()
+	{
+		Keys k{};
+		uint64_t seed = 20250601;               // фиксованный -> детерминизм
+		for (int s = 0; s < 64; ++s)            // перебираем все 64 квадрата
+			for (int c = 0; c < 2; ++c)         // 0 белые 1 черные
+				for (int p = 0; p < 6; ++p)     // 6 типов фигур
+					k.R[c][p][s] = splitmix64(seed);
+		for (int i = 0; i < 16; ++i) k.CASTLE[i] = splitmix64(seed); // 16 комбинаций прав рокировки
+		for (int f = 0; f < 8; ++f)  k.EP[f] = splitmix64(seed);
+		k.SIDE = splitmix64(seed);
+		return k;
+	}
+
+	inline constexpr Keys KEYS = make_keys();
+
+	inline constexpr const auto& R = KEYS.R;           // фигура-цвет-клетка
+	inline constexpr const auto& CASTLE = KEYS.CASTLE; // 4-битная маска прав
+	inline constexpr const auto& EP = KEYS.EP;         // файл en-passant (a-h)
+	inline constexpr uint64_t SIDE = KEYS.SIDE;        // ход стороны
+
+	uint64_t hash(const Position& pos);  // хеш всей позиции
+	uint64_t pawn_hash(const Position& pos); // хеш только пешек (R[c][PAWN][s])
 } // namespace
\ No newline at end of file
@@ -0,0 +1,152 @@
+﻿// tests/nnue_incremental.cpp — ctest: ленивый инкрементальный аккумулятор
+// (DirtyPiece, ходы короля, рокировка, en-passant, превращения, нулевой ход)
+// и пересчёт через Finny-таблицу дают ту же оценку, что полный refresh
+// (NNUE::evaluate)
+#include "nnue_testnet.h"
+
+#include "magic.h"
+#include "movegen.h"
+#include "nnue/accumulator.h"
+#include "nnue/simd.h"
+
+#include <cstdio>
+#include <memory>
+#include <random>
+
+namespace {
+
+    constexpr int MAX_DEPTH = 100;               // < NNUE::STACK_SIZE
+
+    const char* const FENS[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+        "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    };
+
+    struct Stats { long checks = 0, bad = 0; };
+
+    inline bool in_check(const Position& pos) {
+        return pos.attacked(Square(lsb_index(pos.bb[pos.stm][KING])), Side(pos.stm ^ 1));
+    }
+
+    void compare(NNUE::AccumulatorStack& acc, const Position& pos, int ply, Stats& s) {
+        int inc = acc.evaluate(ply, pos);
+        int full = NNUE::evaluate(pos);
+        ++s.checks;
+        if (inc != full && s.bad++ < 10)
+            std::printf("FAIL ply %d: incremental %d, refresh %d\n", ply, inc, full);
+    }
+
+    /* случайное блуждание по дереву, как у поиска: ход вперёд через do_move,
+       откат через undo_move, изредка нулевой ход. evalEvery — оценка на каждом
+       ply, иначе через раз наугад (стек догоняет несколько ходов сразу).
+       kingBias — каждый второй ход королём, если можно: король гуляет по
+       полям и возвращается туда, где Finny-запись посчитана при других фигурах */
+    void walk(NNUE::AccumulatorStack& acc, const Position& root, std::mt19937& rng,
+              int steps, bool evalEvery, bool kingBias, Stats& s)
+    {
+        Position pos = root;
+        StateInfo st[MAX_DEPTH + 1];
+        Move moves[MAX_DEPTH + 1];
+        acc.reset(root);
+        int ply = 0;
+
+        for (int step = 0; step < steps; ++step) {
+            MoveList list;
+            generate_moves(pos, list);
+
+            bool back = ply > 0 && (list.empty() || ply == MAX_DEPTH || rng() % 4 == 0);
+            if (back) {
+                --ply;
+                if (moves[ply]) pos.undo_move(moves[ply], st[ply]);
+                else            pos.undo_null_move(st[ply]);
+            }
+            else if (list.empty())
+                break;
+            else if (rng() % 12 == 0 && !in_check(pos)) {
+                acc.make_null(ply);
+                pos.do_null_move(st[ply]);
+                moves[ply++] = 0;
+            }
+            else {
+                Move m = list[int(rng() % list.size())];
+                if (kingBias && rng() % 2 == 0) {
+                    int kings = 0;
+                    for (Move k : list)
+                        if (pos.piece_on(from_sq(k)) == KING && rng() % ++kings == 0)
+                            m = k;                                  // случайный из ходов короля
+                }
+                acc.make_move(ply, pos, m);
+                pos.do_move(m, st[ply]);
+                moves[ply++] = m;
+            }
+
+            if (evalEvery || rng() % 3 == 0)
+                compare(acc, pos, ply, s);
+        }
+    }
+
+    /* Finny: сразу после reset() король уходит с e1, фигуры меняются
+       (размены), король возвращается — его запись должна догнать доску */
+    const char* const ROUND_TRIP[] = {
+        "e2e4", "e7e5", "e1e2", "g8f6", "b1c3", "b8c6", "e2e1", "f6e4",
+        "c3e4", "d7d5", "e1e2", "d5e4", "e2e1", "d8d2", "e1d2",
+    };
+
+    bool round_trip(NNUE::AccumulatorStack& acc, bool evalEvery, Stats& s)
+    {
+        Position pos;
+        pos.set_startpos();
+        StateInfo st[sizeof(ROUND_TRIP) / sizeof(ROUND_TRIP[0])];
+        acc.reset(pos);
+        int ply = 0;
+        for (const char* uci : ROUND_TRIP) {
+            MoveList list;
+            generate_moves(pos, list);
+            Move m = 0;
+            for (Move k : list)
+                if (uci_move(k) == uci) m = k;
+            if (!m) {
+                std::printf("FAIL round trip: %s is not legal\n", uci);
+                return false;
+            }
+            acc.make_move(ply, pos, m);
+            pos.do_move(m, st[ply++]);
+            if (evalEvery || pos.piece_on(to_sq(m)) == KING)
+                compare(acc, pos, ply, s);
+        }
+        compare(acc, pos, ply, s);
+        return true;
+    }
+
+} // namespace
+
+int main()
+{
+    init_magic();
+    NNUE::Simd::init();
+    if (!TestNet::load_random("nnue_incremental.nnue", 1)) {
+        std::printf("FAIL cannot write/load the test net\n");
+        return 1;
+    }
+
+    /* один стек на все партии: reset() между корнями тоже под проверкой */
+    auto acc = std::make_unique<NNUE::AccumulatorStack>();
+    std::mt19937 rng(7);
+    Stats s;
+    for (int game = 0; game < 600; ++game) {
+        Position root;
+        position_from_fen(root, FENS[game % (sizeof(FENS) / sizeof(FENS[0]))]);
+        walk(*acc, root, rng, 150, game % 2 == 0, game % 3 == 0, s);
+    }
+    for (bool evalEvery : { true, false })
+        if (!round_trip(*acc, evalEvery, s))
+            ++s.bad;
+
+    std::printf("nnue_incremental: %ld checks, %ld mismatches (%s)\n",
+                s.checks, s.bad, NNUE::Simd::kernels().name);
+    return s.bad ? 1 : 0;
+}
@@ -0,0 +1,140 @@
+﻿// tests/nnue_simd.cpp — ctest: каждый собранный и поддерживаемый процессором
+// вариант SIMD-ядер (через Simd::force) считает бит в бит то же, что SCALAR:
+// и отдельные ядра на одних и тех же входах, и оценку позиции целиком
+#include "nnue_testnet.h"
+
+#include "magic.h"
+#include "nnue/simd.h"
+#include "position.h"
+
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace {
+
+    using namespace NNUE;
+
+    const char* const FENS[] = {
+        "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+        "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+        "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+        "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+        "n1n5/PPPk4/8/8/8/8/4Kppp/5N1N b - - 0 1",
+    };
+
+    constexpr int ROWS = 8;                      // строк весов для update
+    constexpr int IN_MAX = 2 * L1;               // самый широкий вход affine_relu
+    constexpr int OUT_MAX = L2;
+
+    /* одни и те же входы для всех вариантов */
+    struct Inputs {
+        std::vector<int16_t> acc, rows;
+        std::vector<uint8_t> in;
+        std::vector<int8_t> w;
+        std::vector<int32_t> b;
+
+        explicit Inputs(uint32_t seed) {
+            std::mt19937 rng(seed);
+            auto rnd = [&](int lo, int hi) { return lo + int(rng() % uint32_t(hi - lo + 1)); };
+            acc.resize(L1);
+            rows.resize(size_t(ROWS) * L1);
+            in.resize(IN_MAX);
+            w.resize(size_t(OUT_MAX) * IN_MAX);
+            b.resize(OUT_MAX);
+            /* захватываем обе границы clip: ниже 0 и выше 127 */
+            for (auto& x : acc)  x = int16_t(rnd(-300, 300));
+            for (auto& x : rows) x = int16_t(rnd(-64, 64));
+            for (auto& x : in)   x = uint8_t(rnd(0, 127));
+            for (auto& x : w)    x = int8_t(rnd(-128, 127));
+            for (auto& x : b)    x = rnd(-20000, 20000);
+        }
+    };
+
+    /* всё, что ядра насчитали на Inputs, одним куском байт */
+    std::vector<uint8_t> run_kernels(const Inputs& x)
+    {
+        const Simd::Kernels& k = Simd::kernels();
+        std::vector<uint8_t> res;
+        auto put = [&](const void* p, size_t n) {
+            const uint8_t* c = static_cast<const uint8_t*>(p);
+            res.insert(res.end(), c, c + n);
+        };
+
+        const int16_t* rows[ROWS];
+        for (int i = 0; i < ROWS; ++i)
+            rows[i] = x.rows.data() + size_t(i) * L1;
+
+        /* update: разные числа add/sub, в том числе dst == src */
+        int16_t dst[L1];
+        for (int nAdd = 0; nAdd <= 4; ++nAdd)
+            for (int nSub = 0; nSub <= 4; ++nSub) {
+                k.update(dst, x.acc.data(), rows, nAdd, rows + 4, nSub);
+                put(dst, sizeof(dst));
+                k.update(dst, dst, rows + 2, nAdd, rows + 1, nSub);
+                put(dst, sizeof(dst));
+            }
+
+        uint8_t clipped[L1];
+        k.clip(x.acc.data(), clipped);
+        put(clipped, sizeof(clipped));
+
+        /* affine_relu: оба размера сети — 2 * L1 -> L2 и L2 -> L3 */
+        uint8_t out[OUT_MAX];
+        k.affine_relu(x.in.data(), 2 * L1, x.w.data(), x.b.data(), out, L2);
+        put(out, L2);
+        k.affine_relu(x.in.data(), L2, x.w.data(), x.b.data(), out, L3);
+        put(out, L3);
+        return res;
+    }
+
+    std::vector<int> run_evals()
+    {
+        std::vector<int> res;
+        for (const char* fen : FENS) {
+            Position pos;
+            position_from_fen(pos, fen);
+            res.push_back(NNUE::evaluate(pos));
+        }
+        return res;
+    }
+
+} // namespace
+
+int main()
+{
+    init_magic();
+    if (!TestNet::load_random("nnue_simd.nnue", 3)) {
+        std::printf("FAIL cannot write/load the test net\n");
+        return 1;
+    }
+
+    std::vector<Inputs> inputs;
+    for (uint32_t seed = 1; seed <= 20; ++seed)
+        inputs.emplace_back(seed);
+
+    Simd::force(Simd::SCALAR);
+    std::vector<std::vector<uint8_t>> refKernels;
+    for (const Inputs& x : inputs)
+        refKernels.push_back(run_kernels(x));
+    const std::vector<int> refEvals = run_evals();
+
+    int bad = 0;
+    for (int a = Simd::SCALAR + 1; a < Simd::ARCH_NB; ++a) {
+        if (!Simd::force(Simd::Arch(a)))
+            continue;                                // не собран или не по процессору
+        const char* name = Simd::kernels().name;
+        int diff = 0;
+        for (size_t i = 0; i < inputs.size(); ++i)
+            if (run_kernels(inputs[i]) != refKernels[i])
+                ++diff;
+        if (run_evals() != refEvals)
+            ++diff;
+        std::printf("%-12s %s\n", name, diff ? "MISMATCH" : "ok");
+        bad += diff;
+    }
+
+    std::printf("nnue_simd: %d mismatches vs scalar\n", bad);
+    return bad ? 1 : 0;
+}
@@ -0,0 +1,52 @@
+﻿#pragma once
+// tests/nnue_testnet.h — случайная сеть для тестов NNUE: своей сети
+// в репозитории нет, а проверяем мы арифметику, а не силу игры
+#include "nnue/nnue.h"
+
+#include <cstdint>
+#include <fstream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace TestNet {
+
+    /* пишет файл в формате NNUE::FileHeader + секции по 64 байта
+       (порядок полей Network) и загружает его; false — не вышло */
+    inline bool load_random(const std::string& path, uint32_t seed)
+    {
+        using namespace NNUE;
+        std::mt19937 rng(seed);
+        auto rnd = [&](int lo, int hi) { return lo + int(rng() % uint32_t(hi - lo + 1)); };
+
+        std::ofstream out(path, std::ios::binary | std::ios::trunc);
+        auto pad = [&]() {
+            static const char zero[64]{};
+            out.write(zero, (64 - out.tellp() % 64) % 64);
+        };
+        auto section = [&](auto type, size_t n, int lo, int hi) {
+            std::vector<decltype(type)> v(n);
+            for (auto& x : v) x = decltype(type)(rnd(lo, hi));
+            out.write(reinterpret_cast<const char*>(v.data()), std::streamsize(n * sizeof(type)));
+            pad();
+        };
+
+        FileHeader h{};
+        for (int i = 0; i < 4; ++i) h.magic[i] = FILE_MAGIC[i];
+        h.version = FILE_VERSION;
+        h.inputs = INPUTS; h.l1 = L1; h.l2 = L2; h.l3 = L3;
+        out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+
+        section(int16_t{}, L1, 0, 60);                                // ftBias
+        section(int16_t{}, size_t(INPUTS) * L1, -20, 20);             // ftWeights
+        section(int32_t{}, L2, -2000, 2000);                          // l1Bias
+        section(int8_t{}, size_t(L2) * 2 * L1, -40, 40);              // l1Weights
+        section(int32_t{}, L3, -2000, 2000);                          // l2Bias
+        section(int8_t{}, size_t(L3) * L2, -60, 60);                  // l2Weights
+        section(int32_t{}, 1, -500, 500);                             // outBias
+        section(int8_t{}, L3, -100, 100);                             // outWeights
+        out.close();
+        return out.good() && load(path);
+    }
+
+} // namespace TestNet
@@ -0,0 +1,61 @@
+﻿// tests/tt_age.cpp — ctest: замена в TT учитывает возраст записей
+#include "tt.h"
+
+#include <cstdio>
+
+namespace {
+
+    /* все ключи — в одном бакете: индекс берётся из старших бит,
+       key16 — из младших */
+    constexpr uint64_t BUCKET_KEY = 0x0123'4567'89AB'0000ULL;
+    inline uint64_t key_of(int i) { return BUCKET_KEY | uint64_t(i + 1); }
+
+    int failures = 0;
+
+    void check(bool ok, const char* what) {
+        if (!ok) {
+            std::printf("FAIL %s\n", what);
+            ++failures;
+        }
+    }
+
+    TT::Entry* store(uint64_t key, int depth, TT::Flag f) {
+        bool found;
+        TT::Entry* e = TT::probe(key, found);
+        e->save(key, depth, 0, f, 0);
+        return e;
+    }
+
+} // namespace
+
+int main()
+{
+    TT::resize(1);
+
+    /* поколение N: бакет целиком занят глубокими записями */
+    TT::new_search();
+    for (int i = 0; i < TT::BUCKET_SIZE; ++i)
+        store(key_of(i), 6, TT::LOWER);
+
+    /* поколение N+1: свежая мелкая запись вытесняет одну из устаревших... */
+    TT::new_search();
+    const uint64_t fresh = key_of(TT::BUCKET_SIZE);
+    store(fresh, 3, TT::UPPER);
+
+    /* ...и переживает следующую новую запись: жертва — снова устаревшая */
+    store(key_of(TT::BUCKET_SIZE + 1), 3, TT::UPPER);
+    bool found;
+    TT::Entry* e = TT::probe(fresh, found);
+    check(found && e->depth() == 3, "fresh entry evicted in favour of a stale one");
+
+    /* та же позиция текущего поколения: мелкий неточный save глубокую не затирает */
+    const uint64_t deep = key_of(TT::BUCKET_SIZE + 2);
+    store(deep, 12, TT::LOWER);
+    store(deep, 2, TT::UPPER);
+    e = TT::probe(deep, found);
+    check(found && e->depth() == 12, "deep same-generation entry overwritten by a shallow one");
+
+    if (failures == 0)
+        std::printf("tt_age: OK\n");
+    return failures ? 1 : 0;
+}